@@ -0,0 +1,327 @@
+// Motion-to-sound latency benchmark: drives DataCollector from myo::Hub, as MyoPyano does, and times every strike
+// from its sensor event's timestamp through each LatencyStage to the mixer starting its voice and the first sample
+// of that voice being mixed. Prints the median, 99th percentile and worst case of each stage, and a histogram of
+// the whole path.
+//
+// Link it against LocalMyo, running in real time (LOCALMYO_SPEED unset or 1), which timestamps events on the steady
+// clock as they fall due; a real armband's timestamps are on a clock of its own. The mixer runs on a fixed clock
+// with no sound device, as HeadlessOutput does, and every pad plays a short synthetic click, so no sound files are
+// needed either. Nothing here uses irrKlang, so it builds and runs without its library.
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../MyoPyano/include/myo/myo.hpp"
+#include "../MyoPyano/src/AsyncLog.hpp"
+#include "../MyoPyano/src/DataCollector.hpp"
+#include "../MyoPyano/src/LatencyProbe.hpp"
+#include "../MyoPyano/src/Mixer.hpp"
+#include "../MyoPyano/src/SampleBank.hpp"
+#include "../MyoPyano/src/SpscRing.hpp"
+#include "../MyoPyano/src/WavFile.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+// Nanoseconds on the steady clock, counted like LocalMyo's microsecond timestamps.
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// The stages after the collector's, on the audio thread.
+enum MixerStage {
+    stageVoiceStarted = collectorStageCount,    // The block that starts the voice is being mixed.
+    stageFirstSample,                           // That block, holding the voice's first sample, is done.
+    stageCount
+};
+
+const char* const stageNames[stageCount] = {
+    "event decode", "orientation math", "strike decision", "zone lookup", "trigger queued", "voice start",
+    "first output sample"
+};
+
+// When one strike passed each of the collector's stages.
+struct StrikeTrace {
+    uint64_t timestamp;
+    int64_t at[collectorStageCount];
+};
+
+// Handed each strike's trace over to the audio thread once it has been triggered.
+struct TraceProbe {
+    TraceProbe()
+    : traces(0)
+    {
+    }
+
+    void event(size_t myoIndex, uint64_t timestamp)
+    {
+        current.timestamp = timestamp;
+        current.at[stageDecoded] = nowNs();
+    }
+
+    void mark(LatencyStage stage)
+    {
+        current.at[stage] = nowNs();
+        if (stage == stageTriggered) {
+            traces->tryPush(current);
+        }
+    }
+
+    SpscRing<StrikeTrace, 1024>* traces;
+    StrikeTrace current;
+};
+
+// A kit archive (see SampleBank::loadArchive()) holding the same short click under every pad's file name.
+class ClickArchive {
+public:
+    explicit ClickArchive(const DrumKit& kit)
+    : _name("clicks")
+    {
+        // 10 ms of a decaying 1 kHz tone, mono.
+        const int sampleRate = 44100;
+        const size_t frames = sampleRate / 100;
+        _wav.resize(wavHeaderSize + frames * 2);
+        makeWavHeader(&_wav[0], 1, sampleRate, static_cast<uint32_t>(frames * 2));
+        for (size_t i = 0; i < frames; i++) {
+            double t = static_cast<double>(i) / sampleRate;
+            int16_t sample = static_cast<int16_t>(16000 * std::exp(-t * 400) * std::sin(2 * M_PI * 1000 * t));
+            writeLittleEndian16(&_wav[wavHeaderSize + i * 2], static_cast<uint16_t>(sample));
+        }
+        for (int i = 0; i < DrumKit::padCount; i++) {
+            _names.push_back(kit.pads[i].fileName);
+        }
+    }
+
+    size_t size() const { return _names.size(); }
+    const char* entryName(size_t index) const { return _names[index].c_str(); }
+    const unsigned char* entryData(size_t index) const { return &_wav[0]; }
+    size_t entrySize(size_t index) const { return _wav.size(); }
+    const std::string& name() const { return _name; }
+
+private:
+    std::vector<unsigned char> _wav;
+    std::vector<std::string> _names;
+    std::string _name;
+};
+
+// Mixes \a mixer on a fixed clock, like HeadlessOutput, and completes the trace of each strike with the voice it
+// started. Each strike starts exactly one voice, since the default zones leave no direction without a pad, so the
+// voices and the traces pair up in order.
+class TimedOutput {
+public:
+    TimedOutput(Mixer& mixer, size_t blockFrames, SpscRing<StrikeTrace, 1024>& traces)
+    : _mixer(mixer)
+    , _blockFrames(blockFrames)
+    , _traces(traces)
+    , _running(false)
+    {
+        for (int s = 0; s < stageCount; s++) {
+            _latencies[s].reserve(1 << 16);
+        }
+    }
+
+    void start()
+    {
+        _running = true;
+        _thread = std::thread(&TimedOutput::run, this);
+    }
+
+    ~TimedOutput()
+    {
+        stop();
+    }
+
+    void stop()
+    {
+        if (_thread.joinable()) {
+            _running = false;
+            _thread.join();
+        }
+    }
+
+    // Nanoseconds from each strike's sensor timestamp to it reaching \a stage.
+    const std::vector<int64_t>& latencies(int stage) const { return _latencies[stage]; }
+
+private:
+    struct VoiceTimes {
+        int64_t started;
+        int64_t mixed;
+    };
+
+    void run()
+    {
+        std::vector<float> block(_blockFrames * 2);
+        std::vector<VoiceTimes> voices;
+        Clock::time_point start = Clock::now();
+        double blockSeconds = static_cast<double>(_blockFrames) / _mixer.sampleRate();
+        for (uint64_t n = 1; _running; n++) {
+            // Triggers are taken at the start of mix(), and the block is only handed on when it is done.
+            uint64_t before = _mixer.voicesStarted();
+            int64_t started = nowNs();
+            _mixer.mix(&block[0], _blockFrames);
+            VoiceTimes times = { started, nowNs() };
+            voices.insert(voices.end(), static_cast<size_t>(_mixer.voicesStarted() - before), times);
+
+            // The trace of a strike is queued just after its trigger, so it may only turn up by the next block.
+            size_t matched = 0;
+            StrikeTrace trace;
+            while (matched < voices.size() && _traces.tryPop(trace)) {
+                record(trace, voices[matched++]);
+            }
+            voices.erase(voices.begin(), voices.begin() + matched);
+
+            std::chrono::duration<double> due(n * blockSeconds);
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(due));
+        }
+    }
+
+    void record(const StrikeTrace& trace, const VoiceTimes& voice)
+    {
+        int64_t origin = static_cast<int64_t>(trace.timestamp) * 1000;
+        for (int s = 0; s < collectorStageCount; s++) {
+            _latencies[s].push_back(trace.at[s] - origin);
+        }
+        _latencies[stageVoiceStarted].push_back(voice.started - origin);
+        _latencies[stageFirstSample].push_back(voice.mixed - origin);
+    }
+
+    Mixer& _mixer;
+    size_t _blockFrames;
+    SpscRing<StrikeTrace, 1024>& _traces;
+    std::atomic<bool> _running;
+    std::thread _thread;
+    std::vector<int64_t> _latencies[stageCount];
+};
+
+// The \a q quantile of \a sorted, in microseconds.
+double quantileUs(const std::vector<int64_t>& sorted, double q)
+{
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()));
+    return sorted[index] / 1000.0;
+}
+
+// Drive the kit for \a seconds and print the latencies.
+int measure(double seconds, int blockFrames, bool directionZones, bool fusion)
+{
+    // The kit complains about every pad it can't find a sample for until the clicks are in the bank. The clicks are
+    // plain PCM, which a bank with no engine parses for the mixer itself.
+    SampleBank bank(0);
+    std::cerr.setstate(std::ios::failbit);
+    DrumKit kit(0, bank);
+    std::cerr.clear();
+    ClickArchive clicks(kit);
+    bank.loadArchive(clicks);
+    kit.useBank(bank);
+
+    Mixer mixer(44100, blockFrames);
+    kit.useMixer(&mixer);
+    SpscRing<StrikeTrace, 1024> traces;
+    DataCollector<PolynomialTrig, TraceProbe> collector(kit, true, directionZones);
+    collector.probe.traces = &traces;
+    // Printed as MyoPyano prints, through the log.
+    AsyncLog log(std::cout);
+    collector.useLog(&log);
+    kit.useLog(&log);
+    if (fusion) {
+        collector.enableFusion(0.010f);
+    }
+
+    myo::Hub hub("com.Pyano.LatencyBench");
+    hub.addListener(&collector);
+    TimedOutput output(mixer, blockFrames, traces);
+    output.start();
+
+    // Every strike logs a few lines, which is part of the path being timed but would bury the results.
+    std::cout.setstate(std::ios::failbit);
+    Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(seconds));
+    while (Clock::now() < end) {
+        hub.run(10);
+    }
+    log.flush();
+    std::cout.clear();
+    output.stop();
+
+    std::vector<int64_t> sorted[stageCount];
+    for (int s = 0; s < stageCount; s++) {
+        sorted[s] = output.latencies(s);
+        std::sort(sorted[s].begin(), sorted[s].end());
+    }
+    if (sorted[0].empty()) {
+        std::cerr << "No strikes in " << seconds << " s" << std::endl;
+        return 1;
+    }
+    double decode = quantileUs(sorted[stageDecoded], 0.5);
+    if (decode < 0 || decode > 1e6) {
+        std::cerr << "Event timestamps aren't on this process's steady clock; run against LocalMyo with "
+                     "LOCALMYO_SPEED=1" << std::endl;
+        return 1;
+    }
+
+    std::cout << sorted[0].size() << " strikes in " << seconds << " s, " << blockFrames
+              << " frame blocks. Microseconds from the event's timestamp:" << std::endl << std::endl;
+    std::cout << std::left << std::setw(22) << "stage" << std::right << std::setw(10) << "p50"
+              << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (int s = 0; s < stageCount; s++) {
+        std::cout << std::left << std::setw(22) << stageNames[s] << std::right
+                  << std::setw(10) << quantileUs(sorted[s], 0.5)
+                  << std::setw(10) << quantileUs(sorted[s], 0.99)
+                  << std::setw(10) << sorted[s].back() / 1000.0 << std::endl;
+    }
+
+    // Whole path, in power of two buckets of microseconds.
+    const std::vector<int64_t>& total = sorted[stageFirstSample];
+    std::cout << std::endl << "first output sample:" << std::endl;
+    size_t i = 0;
+    for (int64_t bucket = 1; i < total.size(); bucket *= 2) {
+        size_t count = 0;
+        while (i < total.size() && total[i] < bucket * 1000) {
+            count++;
+            i++;
+        }
+        if (count == 0 && i == 0) {
+            continue;
+        }
+        std::cout << "  < " << std::setw(7) << bucket << " us " << std::setw(7) << count << ' '
+                  << std::string(count * 50 / total.size(), '#') << std::endl;
+    }
+    return 0;
+}
+
+// Usage: latency-bench [seconds] [--mixer-block <frames>] [--direction-zones] [--fusion]
+int main(int argc, char** argv)
+{
+    double seconds = argc > 1 && argv[1][0] != '-' ? atof(argv[1]) : 30;
+    int blockFrames = 64;
+    bool directionZones = false;
+    bool fusion = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mixer-block") == 0 && i + 1 < argc) {
+            blockFrames = atoi(argv[++i]);
+        }
+        directionZones = directionZones || strcmp(argv[i], "--direction-zones") == 0;
+        fusion = fusion || strcmp(argv[i], "--fusion") == 0;
+    }
+    if (seconds <= 0 || blockFrames <= 0) {
+        std::cerr << "Usage: latency-bench [seconds] [--mixer-block <frames>] [--direction-zones] [--fusion]"
+                  << std::endl;
+        return 1;
+    }
+
+    try {
+        return measure(seconds, blockFrames, directionZones, fusion);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
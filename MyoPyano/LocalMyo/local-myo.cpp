@@ -0,0 +1,764 @@
+// A stand-in for libmyo, the Myo SDK's runtime library, for running MyoPyano and its tools where there is no
+// armband and no Myo Connect, such as a Linux build host. It implements the C API of libmyo.h, so myo::Hub and every
+// DeviceListener run unmodified on top of it. Build it as a shared library under the name of the one it replaces.
+//
+// Where the events come from is chosen with environment variables, read when a hub is created:
+//
+//   LOCALMYO_LOG=<file>       replay an event log made with MyoPyano --record
+//   LOCALMYO_ARMBANDS=<n>     otherwise simulate n armbands drumming, alternately right and left arms (default 2)
+//   LOCALMYO_TEMPO=<bpm>      strokes per minute of each simulated arm (default 120)
+//   LOCALMYO_SPEED=<factor>   how fast time passes; 0 delivers events as fast as they can be handled (default 1)
+//
+// Simulated armbands send orientation, accelerometer and gyroscope data at 50 Hz and, once asked to, EMG at 200 Hz.
+// Each arm raises and drops its stick once a stroke and moves to a different drum in between.
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <queue>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../MyoPyano/include/myo/libmyo.h"
+#include "../MyoPyano/src/EventLog.hpp"
+#include "../MyoPyano/src/MappedFile.hpp"
+
+namespace {
+
+const uint64_t orientationInterval = 20000; // microseconds
+const uint64_t emgInterval = 5000;
+
+class LocalHub;
+
+struct LocalError {
+    libmyo_result_t kind;
+    std::string message;
+};
+
+struct LocalMyo {
+    LocalHub* hub;
+    size_t index;
+    uint64_t macAddress;
+    bool paired;
+    bool locked;
+    bool streamEmg;
+    uint32_t noise;
+};
+
+// What a libmyo_event_t points to. The SensorEvent's myo pointer is not used.
+struct LocalEvent {
+    uint32_t type;
+    LocalMyo* myo;
+    SensorEvent event;
+    int8_t rssi;
+    uint8_t batteryLevel;
+};
+
+libmyo_result_t fail(libmyo_error_details_t* out_error, libmyo_result_t kind, const char* message)
+{
+    if (out_error) {
+        LocalError* error = new LocalError;
+        error->kind = kind;
+        error->message = message;
+        *out_error = error;
+    }
+    return kind;
+}
+
+LocalEvent makeLocalEvent(uint32_t type, LocalMyo* myo, uint64_t timestamp)
+{
+    LocalEvent event;
+    event.type = type;
+    event.myo = myo;
+    event.event = makeSensorEvent(SensorEvent::paired, 0, timestamp);
+    event.rssi = 0;
+    event.batteryLevel = 0;
+    return event;
+}
+
+// The libmyo event type of a recorded event.
+uint32_t libmyoEventType(uint32_t type)
+{
+    switch (type) {
+    case SensorEvent::paired: return libmyo_event_paired;
+    case SensorEvent::unpaired: return libmyo_event_unpaired;
+    case SensorEvent::connected: return libmyo_event_connected;
+    case SensorEvent::disconnected: return libmyo_event_disconnected;
+    case SensorEvent::armSynced: return libmyo_event_arm_synced;
+    case SensorEvent::armUnsynced: return libmyo_event_arm_unsynced;
+    case SensorEvent::unlocked: return libmyo_event_unlocked;
+    case SensorEvent::locked: return libmyo_event_locked;
+    case SensorEvent::motion: return libmyo_event_orientation;
+    case SensorEvent::pose: return libmyo_event_pose;
+    case SensorEvent::emg: return libmyo_event_emg;
+    default: return libmyo_event_warmup_completed;
+    }
+}
+
+double environmentNumber(const char* name, double fallback)
+{
+    const char* value = getenv(name);
+    return value && *value ? atof(value) : fallback;
+}
+
+// Microseconds on the steady clock, which is what timestamps are counted in.
+uint64_t steadyMicroseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Where a hub's events come from, in timestamp order.
+class EventSource {
+public:
+    virtual ~EventSource() {}
+
+    // Timestamp of the next event, or false if there are no more.
+    virtual bool peek(uint64_t& timestamp) = 0;
+
+    // Take the next event.
+    virtual LocalEvent take() = 0;
+};
+
+// Armbands playing the drums, computed on the fly.
+class SyntheticSource : public EventSource {
+public:
+    SyntheticSource(std::vector<LocalMyo*>& myos, uint64_t start, double tempo)
+    : _myos(myos)
+    , _start(start)
+    , _strokesPerSecond(tempo / 60)
+    {
+        for (size_t i = 0; i < myos.size(); i++) {
+            // Stagger the armbands so the events of different arms don't all share a timestamp.
+            uint64_t offset = i * orientationInterval / myos.size();
+            Pending orientation = { start + offset, i, false };
+            Pending emg = { start + offset, i, true };
+            _pending.push(orientation);
+            _pending.push(emg);
+        }
+    }
+
+    bool peek(uint64_t& timestamp)
+    {
+        // Skip the EMG samples of armbands that haven't been asked for them.
+        while (_pending.top().emg && !_myos[_pending.top().myo]->streamEmg) {
+            reschedule();
+        }
+        timestamp = _pending.top().time;
+        return true;
+    }
+
+    LocalEvent take()
+    {
+        uint64_t timestamp;
+        peek(timestamp);
+        Pending next = reschedule();
+        LocalMyo* myo = _myos[next.myo];
+        if (!next.emg) {
+            return motion(myo, next.time);
+        }
+        LocalEvent event = makeLocalEvent(libmyo_event_emg, myo, next.time);
+        for (int i = 0; i < 8; i++) {
+            myo->noise = myo->noise * 1664525u + 1013904223u;
+            event.event.emgData[i] = static_cast<int8_t>(static_cast<int>(myo->noise >> 24) % 41 - 20);
+        }
+        return event;
+    }
+
+private:
+    struct Pending {
+        uint64_t time;
+        size_t myo;
+        bool emg;
+
+        bool operator<(const Pending& other) const { return time > other.time; }
+    };
+
+    // Take the next sample and schedule the one after it.
+    Pending reschedule()
+    {
+        Pending next = _pending.top();
+        _pending.pop();
+        Pending following = next;
+        following.time += next.emg ? emgInterval : orientationInterval;
+        _pending.push(following);
+        return next;
+    }
+
+    // Orientation of \a myo's arm \a seconds after the start: the pitch rises to 70 degrees and falls back once a
+    // stroke, and on the way up the arm turns towards the next drum.
+    myo::Quaternion<float> orientation(const LocalMyo* myo, double seconds) const
+    {
+        static const double drums[] = { 0, 50, -45, 100, -100, 20, -20 };
+        const size_t drumCount = sizeof(drums) / sizeof(drums[0]);
+
+        // Left arms play on the off beat.
+        double strokes = seconds * _strokesPerSecond + (myo->index % 2) * 0.5;
+        double stroke = std::floor(strokes);
+        double phase = strokes - stroke;
+        double pitch = 35 * (1 - std::cos(2 * M_PI * phase));
+
+        size_t current = static_cast<size_t>(stroke) * (myo->index + 3) % drumCount;
+        size_t previous = static_cast<size_t>(stroke + drumCount - 1) * (myo->index + 3) % drumCount;
+        double turn = std::min(1.0, phase * 2);
+        turn = turn * turn * (3 - 2 * turn);
+        double yaw = drums[previous] + (drums[current] - drums[previous]) * turn;
+
+        const float degrees = static_cast<float>(M_PI / 180);
+        return myo::Quaternion<float>::fromAxisAngle(myo::Vector3<float>(0, 0, 1), static_cast<float>(yaw) * degrees) *
+               myo::Quaternion<float>::fromAxisAngle(myo::Vector3<float>(0, 1, 0), static_cast<float>(pitch) * degrees);
+    }
+
+    LocalEvent motion(LocalMyo* myo, uint64_t timestamp) const
+    {
+        double seconds = (timestamp - _start) * 1e-6;
+        myo::Quaternion<float> now = orientation(myo, seconds);
+
+        // The body rate from the change in orientation over a millisecond either side.
+        const double h = 0.0005;
+        myo::Quaternion<float> change = orientation(myo, seconds - h).conjugate() * orientation(myo, seconds + h);
+        float scale = static_cast<float>(2 / (2 * h) * 180 / M_PI);
+        if (change.w() < 0) {
+            scale = -scale;
+        }
+
+        // At rest the accelerometer reads 1 g upwards, which is -z in the armband's world frame.
+        myo::Vector3<float> accel = myo::rotate(now.conjugate(), myo::Vector3<float>(0, 0, -1));
+
+        LocalEvent event = makeLocalEvent(libmyo_event_orientation, myo, timestamp);
+        SensorEvent& data = event.event;
+        data.orientation[0] = now.x();
+        data.orientation[1] = now.y();
+        data.orientation[2] = now.z();
+        data.orientation[3] = now.w();
+        data.accel[0] = accel.x();
+        data.accel[1] = accel.y();
+        data.accel[2] = accel.z();
+        data.gyro[0] = change.x() * scale;
+        data.gyro[1] = change.y() * scale;
+        data.gyro[2] = change.z() * scale;
+        return event;
+    }
+
+    std::vector<LocalMyo*>& _myos;
+    uint64_t _start;
+    double _strokesPerSecond;
+    std::priority_queue<Pending> _pending;
+};
+
+// The events of an event log, with the timestamps moved to start at \a start.
+class LogSource : public EventSource {
+public:
+    LogSource(LocalHub& hub, uint64_t start)
+    : _hub(hub)
+    , _start(start)
+    , _next(0)
+    , _count(0)
+    , _first(0)
+    {
+    }
+
+    bool open(const char* fileName)
+    {
+        if (!_file.open(fileName) || _file.size() < sizeof(EventLogHeader)) {
+            return false;
+        }
+        EventLogHeader header;
+        memcpy(&header, _file.data(), sizeof(header));
+        if (!isEventLogHeader(header)) {
+            return false;
+        }
+        _count = (_file.size() - sizeof(EventLogHeader)) / sizeof(EventRecord);
+        if (_count > 0) {
+            _first = record(0).timestamp;
+        }
+        return true;
+    }
+
+    bool peek(uint64_t& timestamp)
+    {
+        if (_next == _count) {
+            return false;
+        }
+        timestamp = _start + (record(_next).timestamp - _first);
+        return true;
+    }
+
+    LocalEvent take();
+
+private:
+    EventRecord record(size_t index) const
+    {
+        EventRecord result;
+        memcpy(&result, _file.data() + sizeof(EventLogHeader) + index * sizeof(EventRecord), sizeof(result));
+        return result;
+    }
+
+    LocalHub& _hub;
+    uint64_t _start;
+    MappedFile _file;
+    size_t _next;
+    size_t _count;
+    uint64_t _first;
+};
+
+class LocalHub {
+public:
+    LocalHub()
+    : _speed(environmentNumber("LOCALMYO_SPEED", 1))
+    , _realStart(std::chrono::steady_clock::now())
+    , _start(steadyMicroseconds())
+    , _time(_start)
+    , _source(0)
+    {
+    }
+
+    ~LocalHub()
+    {
+        delete _source;
+        for (size_t i = 0; i < _myos.size(); i++) {
+            delete _myos[i];
+        }
+    }
+
+    libmyo_result_t init(libmyo_error_details_t* out_error)
+    {
+        if (const char* log = getenv("LOCALMYO_LOG")) {
+            LogSource* source = new LogSource(*this, _start);
+            _source = source;
+            if (!source->open(log)) {
+                return fail(out_error, libmyo_error_runtime, "LOCALMYO_LOG is not a readable event log");
+            }
+            return libmyo_success;
+        }
+
+        int armbands = static_cast<int>(environmentNumber("LOCALMYO_ARMBANDS", 2));
+        double tempo = environmentNumber("LOCALMYO_TEMPO", 120);
+        if (armbands < 0 || tempo <= 0) {
+            return fail(out_error, libmyo_error_invalid_argument, "LOCALMYO_ARMBANDS or LOCALMYO_TEMPO is out of range");
+        }
+        for (int i = 0; i < armbands; i++) {
+            LocalMyo* myo = addMyo();
+            pair(myo, _start);
+            LocalEvent synced = makeLocalEvent(libmyo_event_arm_synced, myo, _start);
+            synced.event.arm = i % 2 ? libmyo_arm_left : libmyo_arm_right;
+            synced.event.xDirection = libmyo_x_direction_toward_wrist;
+            synced.event.warmupState = libmyo_warmup_state_warm;
+            queue(synced);
+        }
+        if (armbands > 0) {
+            _source = new SyntheticSource(_myos, _start, tempo);
+        }
+        return libmyo_success;
+    }
+
+    // Deliver events to \a handler until \a duration_ms has passed, or the handler asks to stop.
+    libmyo_result_t run(unsigned int duration_ms, libmyo_handler_t handler, void* user_data)
+    {
+        uint64_t end = (_speed > 0 ? now() : _time) + static_cast<uint64_t>(duration_ms) * 1000;
+        for (;;) {
+            while (!_queued.empty()) {
+                LocalEvent event = _queued.front();
+                _queued.pop_front();
+                if (handler(user_data, &event) == libmyo_handler_stop) {
+                    return libmyo_success;
+                }
+            }
+
+            uint64_t next;
+            if (!_source || !_source->peek(next) || next > end) {
+                waitUntil(end);
+                _time = end;
+                return libmyo_success;
+            }
+            waitUntil(next);
+            _time = next;
+            LocalEvent event = _source->take();
+            if (handler(user_data, &event) == libmyo_handler_stop) {
+                return libmyo_success;
+            }
+        }
+    }
+
+    // Deliver \a event at the start of the next run, or straight after the current event.
+    void queue(const LocalEvent& event) { _queued.push_back(event); }
+
+    // The current timestamp.
+    uint64_t now() const
+    {
+        if (_speed <= 0) {
+            return _time;
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - _realStart;
+        return _start + static_cast<uint64_t>(elapsed.count() * _speed);
+    }
+
+    LocalMyo* addMyo()
+    {
+        LocalMyo* myo = new LocalMyo;
+        myo->hub = this;
+        myo->index = _myos.size();
+        myo->macAddress = 0x0000c0ffee000000ull + _myos.size();
+        myo->paired = false;
+        myo->locked = true;
+        myo->streamEmg = false;
+        myo->noise = static_cast<uint32_t>(_myos.size()) + 1;
+        _myos.push_back(myo);
+        return myo;
+    }
+
+    // Queue the paired and connected events of \a myo.
+    void pair(LocalMyo* myo, uint64_t timestamp)
+    {
+        myo->paired = true;
+        LocalEvent paired = makeLocalEvent(libmyo_event_paired, myo, timestamp);
+        paired.event.firmware[0] = 1;
+        paired.event.firmware[1] = 5;
+        paired.event.firmware[2] = 1970;
+        paired.event.firmware[3] = libmyo_hardware_rev_d;
+        queue(paired);
+        LocalEvent connected = paired;
+        connected.type = libmyo_event_connected;
+        queue(connected);
+    }
+
+    // The stand-in for recorded armband \a device, made the first time it's asked for.
+    LocalMyo* myoFor(size_t device)
+    {
+        while (_myos.size() <= device) {
+            addMyo();
+        }
+        return _myos[device];
+    }
+
+private:
+    // Sleep until the timestamp \a time is due. Does nothing when running flat out.
+    void waitUntil(uint64_t time) const
+    {
+        if (_speed <= 0 || time <= _start) {
+            return;
+        }
+        std::chrono::microseconds due(static_cast<int64_t>((time - _start) / _speed));
+        std::this_thread::sleep_until(_realStart + due);
+    }
+
+    double _speed;
+    std::chrono::steady_clock::time_point _realStart;
+    uint64_t _start;
+    uint64_t _time;
+    EventSource* _source;
+    std::vector<LocalMyo*> _myos;
+    std::deque<LocalEvent> _queued;
+};
+
+LocalEvent LogSource::take()
+{
+    uint64_t timestamp = 0;
+    peek(timestamp);
+    EventRecord next = record(_next);
+    LocalMyo* myo = _hub.myoFor(next.device);
+    if (!myo->paired && next.type != SensorEvent::paired) {
+        // The recording started after the armband paired, but the Hub ignores the events of armbands it hasn't seen
+        // pair. Pair it first, and deliver the recorded event next time.
+        myo->paired = true;
+        LocalEvent paired = makeLocalEvent(libmyo_event_paired, myo, timestamp);
+        paired.event.firmware[0] = 1;
+        paired.event.firmware[1] = 5;
+        paired.event.firmware[3] = libmyo_hardware_rev_d;
+        return paired;
+    }
+    _next++;
+    if (next.type == SensorEvent::paired) {
+        myo->paired = true;
+    }
+
+    LocalEvent event = makeLocalEvent(libmyoEventType(next.type), myo, timestamp);
+    event.event = fromEventRecord(next, 0);
+    event.event.timestamp = timestamp;
+    return event;
+}
+
+const LocalEvent* localEvent(libmyo_event_t event)
+{
+    return static_cast<const LocalEvent*>(event);
+}
+
+} // namespace
+
+extern "C" {
+
+const char* libmyo_error_cstring(libmyo_error_details_t error)
+{
+    return static_cast<LocalError*>(error)->message.c_str();
+}
+
+libmyo_result_t libmyo_error_kind(libmyo_error_details_t error)
+{
+    return static_cast<LocalError*>(error)->kind;
+}
+
+void libmyo_free_error_details(libmyo_error_details_t error)
+{
+    delete static_cast<LocalError*>(error);
+}
+
+const char* libmyo_string_c_str(libmyo_string_t string)
+{
+    return static_cast<std::string*>(string)->c_str();
+}
+
+void libmyo_string_free(libmyo_string_t string)
+{
+    delete static_cast<std::string*>(string);
+}
+
+libmyo_string_t libmyo_mac_address_to_string(uint64_t address)
+{
+    char text[18];
+    snprintf(text, sizeof(text), "%02x-%02x-%02x-%02x-%02x-%02x",
+             static_cast<unsigned int>(address >> 40) & 0xff, static_cast<unsigned int>(address >> 32) & 0xff,
+             static_cast<unsigned int>(address >> 24) & 0xff, static_cast<unsigned int>(address >> 16) & 0xff,
+             static_cast<unsigned int>(address >> 8) & 0xff, static_cast<unsigned int>(address) & 0xff);
+    return new std::string(text);
+}
+
+uint64_t libmyo_string_to_mac_address(const char* string)
+{
+    unsigned int bytes[6];
+    char end;
+    if (!string || sscanf(string, "%2x-%2x-%2x-%2x-%2x-%2x%c", &bytes[0], &bytes[1], &bytes[2], &bytes[3],
+                          &bytes[4], &bytes[5], &end) != 6) {
+        return 0;
+    }
+    uint64_t address = 0;
+    for (int i = 0; i < 6; i++) {
+        address = address << 8 | bytes[i];
+    }
+    return address;
+}
+
+libmyo_result_t libmyo_init_hub(libmyo_hub_t* out_hub, const char* application_identifier,
+                                libmyo_error_details_t* out_error)
+{
+    if (!out_hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "out_hub is null");
+    }
+    if (application_identifier && strlen(application_identifier) > 255) {
+        return fail(out_error, libmyo_error_invalid_argument, "application_identifier is too long");
+    }
+    LocalHub* hub = new LocalHub;
+    libmyo_result_t result = hub->init(out_error);
+    if (result != libmyo_success) {
+        delete hub;
+        return result;
+    }
+    *out_hub = hub;
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_shutdown_hub(libmyo_hub_t hub, libmyo_error_details_t* out_error)
+{
+    if (!hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "hub is null");
+    }
+    delete static_cast<LocalHub*>(hub);
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_set_locking_policy(libmyo_hub_t hub, libmyo_locking_policy_t locking_policy,
+                                          libmyo_error_details_t* out_error)
+{
+    // Simulated armbands make no poses, so there is nothing for the policy to hold back.
+    if (!hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "hub is null");
+    }
+    return libmyo_success;
+}
+
+uint64_t libmyo_get_mac_address(libmyo_myo_t myo)
+{
+    return myo ? static_cast<LocalMyo*>(myo)->macAddress : 0;
+}
+
+libmyo_result_t libmyo_vibrate(libmyo_myo_t myo, libmyo_vibration_type_t type, libmyo_error_details_t* out_error)
+{
+    return myo ? libmyo_success : fail(out_error, libmyo_error_invalid_argument, "myo is null");
+}
+
+libmyo_result_t libmyo_request_rssi(libmyo_myo_t myo, libmyo_error_details_t* out_error)
+{
+    if (!myo) {
+        return fail(out_error, libmyo_error_invalid_argument, "myo is null");
+    }
+    LocalMyo* local = static_cast<LocalMyo*>(myo);
+    LocalEvent event = makeLocalEvent(libmyo_event_rssi, local, local->hub->now());
+    event.rssi = -50;
+    local->hub->queue(event);
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_request_battery_level(libmyo_myo_t myo, libmyo_error_details_t* out_error)
+{
+    if (!myo) {
+        return fail(out_error, libmyo_error_invalid_argument, "myo is null");
+    }
+    LocalMyo* local = static_cast<LocalMyo*>(myo);
+    LocalEvent event = makeLocalEvent(libmyo_event_battery_level, local, local->hub->now());
+    event.batteryLevel = 100;
+    local->hub->queue(event);
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_set_stream_emg(libmyo_myo_t myo, libmyo_stream_emg_t emg, libmyo_error_details_t* out_error)
+{
+    if (!myo) {
+        return fail(out_error, libmyo_error_invalid_argument, "myo is null");
+    }
+    static_cast<LocalMyo*>(myo)->streamEmg = emg == libmyo_stream_emg_enabled;
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_myo_unlock(libmyo_myo_t myo, libmyo_unlock_type_t type, libmyo_error_details_t* out_error)
+{
+    if (!myo) {
+        return fail(out_error, libmyo_error_invalid_argument, "myo is null");
+    }
+    LocalMyo* local = static_cast<LocalMyo*>(myo);
+    if (local->locked) {
+        local->locked = false;
+        local->hub->queue(makeLocalEvent(libmyo_event_unlocked, local, local->hub->now()));
+    }
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_myo_lock(libmyo_myo_t myo, libmyo_error_details_t* out_error)
+{
+    if (!myo) {
+        return fail(out_error, libmyo_error_invalid_argument, "myo is null");
+    }
+    LocalMyo* local = static_cast<LocalMyo*>(myo);
+    if (!local->locked) {
+        local->locked = true;
+        local->hub->queue(makeLocalEvent(libmyo_event_locked, local, local->hub->now()));
+    }
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_myo_notify_user_action(libmyo_myo_t myo, libmyo_user_action_type_t type,
+                                              libmyo_error_details_t* out_error)
+{
+    return myo ? libmyo_success : fail(out_error, libmyo_error_invalid_argument, "myo is null");
+}
+
+uint32_t libmyo_event_get_type(libmyo_event_t event)
+{
+    return localEvent(event)->type;
+}
+
+uint64_t libmyo_event_get_timestamp(libmyo_event_t event)
+{
+    return localEvent(event)->event.timestamp;
+}
+
+libmyo_myo_t libmyo_event_get_myo(libmyo_event_t event)
+{
+    return localEvent(event)->myo;
+}
+
+uint64_t libmyo_event_get_mac_address(libmyo_event_t event)
+{
+    return localEvent(event)->myo->macAddress;
+}
+
+libmyo_string_t libmyo_event_get_myo_name(libmyo_event_t event)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "Local Myo %u", static_cast<unsigned int>(localEvent(event)->myo->index + 1));
+    return new std::string(name);
+}
+
+unsigned int libmyo_event_get_firmware_version(libmyo_event_t event, libmyo_version_component_t component)
+{
+    return static_cast<unsigned int>(component) < 4 ?
+           localEvent(event)->event.firmware[component] : 0;
+}
+
+libmyo_arm_t libmyo_event_get_arm(libmyo_event_t event)
+{
+    return static_cast<libmyo_arm_t>(localEvent(event)->event.arm);
+}
+
+libmyo_x_direction_t libmyo_event_get_x_direction(libmyo_event_t event)
+{
+    return static_cast<libmyo_x_direction_t>(localEvent(event)->event.xDirection);
+}
+
+libmyo_warmup_state_t libmyo_event_get_warmup_state(libmyo_event_t event)
+{
+    return static_cast<libmyo_warmup_state_t>(localEvent(event)->event.warmupState);
+}
+
+libmyo_warmup_result_t libmyo_event_get_warmup_result(libmyo_event_t event)
+{
+    return static_cast<libmyo_warmup_result_t>(localEvent(event)->event.warmupResult);
+}
+
+float libmyo_event_get_rotation_on_arm(libmyo_event_t event)
+{
+    return localEvent(event)->event.rotation;
+}
+
+float libmyo_event_get_orientation(libmyo_event_t event, libmyo_orientation_index index)
+{
+    return static_cast<unsigned int>(index) < 4 ? localEvent(event)->event.orientation[index] : 0;
+}
+
+float libmyo_event_get_accelerometer(libmyo_event_t event, unsigned int index)
+{
+    return index < 3 ? localEvent(event)->event.accel[index] : 0;
+}
+
+float libmyo_event_get_gyroscope(libmyo_event_t event, unsigned int index)
+{
+    return index < 3 ? localEvent(event)->event.gyro[index] : 0;
+}
+
+libmyo_pose_t libmyo_event_get_pose(libmyo_event_t event)
+{
+    return static_cast<libmyo_pose_t>(localEvent(event)->event.poseType);
+}
+
+int8_t libmyo_event_get_rssi(libmyo_event_t event)
+{
+    return localEvent(event)->rssi;
+}
+
+uint8_t libmyo_event_get_battery_level(libmyo_event_t event)
+{
+    return localEvent(event)->batteryLevel;
+}
+
+int8_t libmyo_event_get_emg(libmyo_event_t event, unsigned int sensor)
+{
+    return sensor < 8 ? localEvent(event)->event.emgData[sensor] : 0;
+}
+
+libmyo_result_t libmyo_run(libmyo_hub_t hub, unsigned int duration_ms, libmyo_handler_t handler, void* user_data,
+                           libmyo_error_details_t* out_error)
+{
+    if (!hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "hub is null");
+    }
+    if (!handler) {
+        return fail(out_error, libmyo_error_invalid_argument, "handler is null");
+    }
+    return static_cast<LocalHub*>(hub)->run(duration_ms, handler, user_data);
+}
+
+} // extern "C"
@@ -4,7 +4,8 @@
 
 #include <vector>
 
-#include "..\libmyo.h"
+#include "../libmyo.h"
+#include "../../../src/DeviceRegistry.hpp"
 
 namespace myo {
 
@@ -72,6 +73,9 @@ protected:
 
     libmyo_hub_t _hub;
     std::vector<Myo*> _myos;
+
+    // Gives each libmyo object the index of its Myo in _myos, so lookupMyo() costs the same however many are paired.
+    DeviceRegistry<void> _myoIndices;
     std::vector<DeviceListener*> _listeners;
 
     /// @endcond
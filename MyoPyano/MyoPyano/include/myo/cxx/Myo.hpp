@@ -2,7 +2,7 @@
 // Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
 #pragma once
 
-#include "..\include\myo\libmyo.h"
+#include "../libmyo.h"
 
 
 namespace myo {
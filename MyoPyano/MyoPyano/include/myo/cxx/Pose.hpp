@@ -6,7 +6,7 @@
 #include <string>
 
 
-#include "..\libmyo.h"
+#include "../libmyo.h"
 
 namespace myo {
 
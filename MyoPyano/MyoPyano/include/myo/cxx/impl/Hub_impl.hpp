@@ -18,6 +18,7 @@ inline
 Hub::Hub(const std::string& applicationIdentifier)
 : _hub(0)
 , _myos()
+, _myoIndices()
 , _listeners()
 {
     libmyo_init_hub(&_hub, applicationIdentifier.c_str(), ThrowOnError());
@@ -241,15 +242,12 @@ libmyo_hub_t Hub::libmyoObject()
 inline
 Myo* Hub::lookupMyo(libmyo_myo_t opaqueMyo) const
 {
-    Myo* myo = 0;
-    for (std::vector<Myo*>::const_iterator I = _myos.begin(), IE = _myos.end(); I != IE; ++I) {
-        if ((*I)->libmyoObject() == opaqueMyo) {
-            myo = *I;
-            break;
-        }
+    std::size_t index = _myoIndices.find(opaqueMyo);
+    if (index == DeviceRegistry<void>::notFound) {
+        return 0;
     }
 
-    return myo;
+    return _myos[index];
 }
 
 inline
@@ -258,6 +256,7 @@ Myo* Hub::addMyo(libmyo_myo_t opaqueMyo)
     Myo* myo = new Myo(opaqueMyo);
 
     _myos.push_back(myo);
+    _myoIndices.add(opaqueMyo);
 
     return myo;
 }
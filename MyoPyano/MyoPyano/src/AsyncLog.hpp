@@ -0,0 +1,227 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+#include "SpscRing.hpp"
+
+// A line of log text, formatted into a fixed buffer so that building one never allocates. Anything past the
+// capacity is cut off.
+class LogLine {
+public:
+    static const size_t capacity = 247;
+
+    LogLine()
+    : _length(0)
+    {
+        _text[0] = 0;
+    }
+
+    const char* c_str() const { return _text; }
+
+    size_t length() const { return _length; }
+
+    LogLine& operator<<(const char* text)
+    {
+        while (*text && _length < capacity) {
+            _text[_length++] = *text++;
+        }
+        _text[_length] = 0;
+        return *this;
+    }
+
+    LogLine& operator<<(char c)
+    {
+        char text[2] = { c, 0 };
+        return *this << text;
+    }
+
+    LogLine& operator<<(long long value)
+    {
+        // Digits are produced backwards, least significant first.
+        char digits[24];
+        size_t count = 0;
+        unsigned long long magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value) : value;
+        do {
+            digits[count++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (value < 0) {
+            digits[count++] = '-';
+        }
+        char text[24];
+        for (size_t i = 0; i < count; i++) {
+            text[i] = digits[count - 1 - i];
+        }
+        text[count] = 0;
+        return *this << text;
+    }
+
+    LogLine& operator<<(int value) { return *this << static_cast<long long>(value); }
+
+    LogLine& operator<<(size_t value) { return *this << static_cast<long long>(value); }
+
+    // Like std::ostream's default, six significant digits. snprintf() costs microseconds, so values from 1 up to a
+    // million, like strike velocities, are formatted here.
+    LogLine& operator<<(float value)
+    {
+        double magnitude = value < 0 ? -static_cast<double>(value) : value;
+        if (!(magnitude >= 1 && magnitude < 999999.5)) {
+            char text[32];
+            snprintf(text, sizeof(text), "%g", value);
+            return *this << text;
+        }
+        int decimals = 5;
+        long long scale = 100000;
+        for (double limit = 10; magnitude >= limit; limit *= 10) {
+            decimals--;
+            scale /= 10;
+        }
+        // A float times a power of ten up to 10^5 is exact in a double, so ties are exact too; like printf, round
+        // them to even.
+        double exact = magnitude * scale;
+        long long scaled = static_cast<long long>(exact);
+        double rest = exact - scaled;
+        if (rest > 0.5 || (rest == 0.5 && (scaled & 1))) {
+            scaled++;
+        }
+        long long fraction = scaled % scale;
+        if (value < 0) {
+            *this << '-';
+        }
+        *this << scaled / scale;
+        if (fraction == 0) {
+            return *this;
+        }
+        // The fraction's digits, without the trailing zeros.
+        char digits[8];
+        for (int i = decimals - 1; i >= 0; i--) {
+            digits[i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        int length = decimals;
+        while (digits[length - 1] == '0') {
+            length--;
+        }
+        digits[length] = 0;
+        return *this << '.' << digits;
+    }
+
+private:
+    char _text[capacity + 1];
+    size_t _length;
+};
+
+// AsyncLog takes lines of text from one thread, the one detecting strikes, and writes them to a stream on a thread
+// of its own, so a slow console never holds up a drum sound. write() only copies the line into a lock-free ring; it
+// doesn't wake the writer either, which looks for new lines every few milliseconds. If the writer falls that far
+// behind, lines are dropped and counted rather than waited for.
+class AsyncLog {
+public:
+    static const size_t queueLines = 1024;
+
+    explicit AsyncLog(std::ostream& out)
+    : _out(out)
+    , _running(true)
+    , _queued(0)
+    , _dropped(0)
+    , _written(0)
+    {
+        _thread = std::thread(&AsyncLog::run, this);
+    }
+
+    // Writes out every line still queued.
+    ~AsyncLog()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _running = false;
+        }
+        _wake.notify_one();
+        _thread.join();
+    }
+
+    // Queue \a line. Called from the one thread that writes to the log.
+    void write(const LogLine& line)
+    {
+        if (_lines.tryPush(line)) {
+            _queued.store(_queued.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        } else {
+            _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+    // Wait until every line queued so far has been written. Called from the thread that writes to the log.
+    void flush()
+    {
+        uint64_t queued = _queued.load(std::memory_order_relaxed);
+        while (_written.load(std::memory_order_acquire) < queued) {
+            _wake.notify_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Lines lost because the writer fell behind.
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;) {
+            bool stopping = !_running;
+            lock.unlock();
+            LogLine line;
+            uint64_t written = 0;
+            while (_lines.tryPop(line)) {
+                _out.write(line.c_str(), line.length());
+                written++;
+            }
+            if (written) {
+                _out.flush();
+                _written.fetch_add(written, std::memory_order_release);
+            }
+            lock.lock();
+            if (stopping) {
+                break;
+            }
+            _wake.wait_for(lock, std::chrono::milliseconds(5));
+        }
+    }
+
+    std::ostream& _out;
+    SpscRing<LogLine, queueLines> _lines;
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _running;
+
+    // Only written by the thread writing to the log.
+    std::atomic<uint64_t> _queued;
+    std::atomic<uint64_t> _dropped;
+
+    // Only written by the writer thread.
+    std::atomic<uint64_t> _written;
+
+    // Not implemented
+    AsyncLog(const AsyncLog&);
+    AsyncLog& operator=(const AsyncLog&);
+};
+
+// Write \a line to \a log, or straight to std::cout if there is no log.
+inline void writeLog(AsyncLog* log, const LogLine& line)
+{
+    if (log) {
+        log->write(line);
+    } else {
+        std::cout << line.c_str() << std::flush;
+    }
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/irrKlang/irrKlang.h"
+#include "Mixer.hpp"
+#include "MixerStream.hpp"
+#include "WavFile.hpp"
+
+// Where a Mixer's output goes. Whatever the output, it pulls blocks out of Mixer::mix() on its own thread; strikes
+// only ever queue triggers.
+class AudioOutput {
+public:
+    virtual ~AudioOutput() {}
+
+    // Start pulling audio out of the mixer. Returns false if the output couldn't be started.
+    virtual bool start() = 0;
+
+    // Stop pulling audio. The output can't be started again.
+    virtual void stop() = 0;
+};
+
+// Plays the mixer on the sound device, as one endless irrKlang stream (see MixerStream).
+class IrrKlangOutput : public AudioOutput {
+public:
+    IrrKlangOutput(irrklang::ISoundEngine* engine, Mixer& mixer, size_t blockFrames)
+    : _engine(engine)
+    , _mixer(mixer)
+    , _blockFrames(blockFrames)
+    , _sound(0)
+    {
+    }
+
+    ~IrrKlangOutput()
+    {
+        stop();
+    }
+
+    bool start()
+    {
+        if (_sound) {
+            return true;
+        }
+        MixerStreamLoader* loader = new MixerStreamLoader(_mixer, _blockFrames);
+        _engine->registerAudioStreamLoader(loader);
+        loader->drop();
+        MixerFileFactory* files = new MixerFileFactory();
+        _engine->addFileFactory(files);
+        files->drop();
+
+        // play2D() only returns the sound when it is tracked.
+        _sound = _engine->play2D(mixerStreamName, true, false, true, irrklang::ESM_STREAMING);
+        return _sound != 0;
+    }
+
+    void stop()
+    {
+        if (_sound) {
+            _sound->stop();
+            _sound->drop();
+            _sound = 0;
+        }
+    }
+
+private:
+    irrklang::ISoundEngine* _engine;
+    Mixer& _mixer;
+    size_t _blockFrames;
+    irrklang::ISound* _sound;
+
+    // Not implemented
+    IrrKlangOutput(const IrrKlangOutput&);
+    IrrKlangOutput& operator=(const IrrKlangOutput&);
+};
+
+// Mixes without a sound device, into memory and/or a 16 bit WAV file, for running where there is no sound card.
+//
+// After start() a thread mixes one block every block period of wall time, on a fixed clock that doesn't drift
+// however long each mix takes, so the output lines up with the input as it would on a real device. Alternatively,
+// render() mixes on the calling thread as fast as it is called, which lets a replay advance the audio in lockstep
+// with the events and get identical output on every run.
+class HeadlessOutput : public AudioOutput {
+public:
+    HeadlessOutput(Mixer& mixer, size_t blockFrames)
+    : _mixer(mixer)
+    , _blockFrames(blockFrames < mixer.maxBlockFrames() ? blockFrames : mixer.maxBlockFrames())
+    , _block(_blockFrames * 2)
+    , _samples(_blockFrames * 2)
+    , _keepInMemory(false)
+    , _wav(0)
+    , _wavBytes(0)
+    , _running(false)
+    , _framesRendered(0)
+    {
+    }
+
+    ~HeadlessOutput()
+    {
+        stop();
+    }
+
+    // Also write the output to the WAV file \a fileName. Returns false if it can't be created.
+    bool openWav(const std::string& fileName)
+    {
+        _wav = fopen(fileName.c_str(), "wb");
+        if (!_wav) {
+            return false;
+        }
+        // Until stop() knows the real size, the header claims the largest possible one, as streamed WAV files do, so
+        // a run that is killed still leaves a playable file.
+        unsigned char header[wavHeaderSize];
+        makeWavHeader(header, 2, _mixer.sampleRate(), 0xFFFFFFFFu - static_cast<uint32_t>(wavHeaderSize));
+        return fwrite(header, 1, sizeof(header), _wav) == sizeof(header);
+    }
+
+    // Keep the whole output, as interleaved stereo floats, in memory().
+    void keepInMemory(bool keep) { _keepInMemory = keep; }
+
+    const std::vector<float>& memory() const { return _memory; }
+
+    bool start()
+    {
+        if (_running.exchange(true)) {
+            return true;
+        }
+        _thread = std::thread(&HeadlessOutput::run, this);
+        return true;
+    }
+
+    // Stop the clock thread, if started, and finish the WAV file.
+    void stop()
+    {
+        if (_running.exchange(false)) {
+            _thread.join();
+        }
+        if (_wav) {
+            // Now the size is known.
+            unsigned char header[wavHeaderSize];
+            makeWavHeader(header, 2, _mixer.sampleRate(), _wavBytes);
+            fseek(_wav, 0, SEEK_SET);
+            fwrite(header, 1, sizeof(header), _wav);
+            fclose(_wav);
+            _wav = 0;
+        }
+    }
+
+    // Mix \a frames frames on this thread, in whole blocks. Don't mix this with start().
+    void render(uint64_t frames)
+    {
+        for (uint64_t done = 0; done < frames; done += _blockFrames) {
+            renderBlock();
+        }
+    }
+
+    // Frames mixed so far. Can be read from any thread.
+    uint64_t framesRendered() const { return _framesRendered.load(std::memory_order_acquire); }
+
+private:
+    void run()
+    {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+        double blockSeconds = static_cast<double>(_blockFrames) / _mixer.sampleRate();
+        for (uint64_t block = 1; _running.load(std::memory_order_relaxed); block++) {
+            renderBlock();
+            std::chrono::duration<double> due(block * blockSeconds);
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(due));
+        }
+    }
+
+    void renderBlock()
+    {
+        _mixer.mix(&_block[0], _blockFrames);
+        if (_keepInMemory) {
+            _memory.insert(_memory.end(), _block.begin(), _block.end());
+        }
+        if (_wav) {
+            floatToS16(&_block[0], &_samples[0], _block.size());
+            _wavBytes += static_cast<uint32_t>(fwrite(&_samples[0], 2, _samples.size(), _wav) * 2);
+        }
+        _framesRendered.fetch_add(_blockFrames, std::memory_order_release);
+    }
+
+    Mixer& _mixer;
+    size_t _blockFrames;
+    std::vector<float> _block;
+    std::vector<int16_t> _samples;
+    bool _keepInMemory;
+    std::vector<float> _memory;
+    FILE* _wav;
+    uint32_t _wavBytes;
+    std::thread _thread;
+    std::atomic<bool> _running;
+    std::atomic<uint64_t> _framesRendered;
+
+    // Not implemented
+    HeadlessOutput(const HeadlessOutput&);
+    HeadlessOutput& operator=(const HeadlessOutput&);
+};
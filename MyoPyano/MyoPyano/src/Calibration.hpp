@@ -0,0 +1,156 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <stdint.h>
+
+#include "../include/myo/myo.hpp"
+
+// Calibration holds the origin an arm's angles are measured from, and keeps its heading in step with the armband's
+// yaw drift so the kit doesn't slowly rotate away from the drummer.
+//
+// The armband has no compass, so its yaw wanders by itself. Whenever the gyroscope shows the arm has been still for
+// restTime, any change in the reported heading can only be drift, so the origin is turned by the same amount and
+// the drift rate is estimated from it. While the arm moves, the origin keeps turning at that estimated rate. Both
+// are small incremental updates; nothing is recaptured.
+class Calibration {
+public:
+    // The arm is at rest while the gyroscope reads below \a restRate deg/s for at least \a restTime microseconds.
+    Calibration(float restRate = 8.0f, uint64_t restTime = 300000)
+    : _restRate(restRate)
+    , _restTime(restTime)
+    {
+        reset();
+    }
+
+    // Forget the origin; the arm is uncalibrated until calibrate() is called again.
+    void reset()
+    {
+        _calibrated = false;
+        _origin = myo::Quaternion<float>();
+        _originHeading = 0;
+        _driftRate = 0;
+        _driftTotal = 0;
+        _lastTimestamp = 0;
+        _stillSince = 0;
+        _still = false;
+        _hasRestHeading = false;
+        _restHeading = 0;
+    }
+
+    // Take \a orientation as the origin.
+    void calibrate(const myo::Quaternion<float>& orientation)
+    {
+        reset();
+        _origin = orientation;
+        _originHeading = heading(orientation);
+        _calibrated = true;
+    }
+
+    // Feed one sample of the armband's orientation and gyroscope (deg/s). Does nothing until calibrated.
+    void update(uint64_t timestamp, const myo::Quaternion<float>& orientation, const myo::Vector3<float>& gyro)
+    {
+        if (!_calibrated) {
+            return;
+        }
+        float dt = _lastTimestamp && timestamp > _lastTimestamp ? (timestamp - _lastTimestamp) * 1e-6f : 0;
+        _lastTimestamp = timestamp;
+
+        if (gyro.magnitude() >= _restRate) {
+            _still = false;
+            _hasRestHeading = false;
+            turnOrigin(_driftRate * dt);
+            return;
+        }
+        if (!_still) {
+            _still = true;
+            _stillSince = timestamp;
+        }
+        if (timestamp - _stillSince < _restTime) {
+            turnOrigin(_driftRate * dt);
+            return;
+        }
+
+        // At rest. Pointing nearly straight up or down the heading means nothing, so skip those samples.
+        myo::Vector3<float> forward = myo::rotate(orientation, myo::Vector3<float>(1, 0, 0));
+        if (forward.x() * forward.x() + forward.y() * forward.y() < 0.04f) {
+            _hasRestHeading = false;
+            return;
+        }
+        float now = heading(orientation);
+        if (_hasRestHeading && dt > 0) {
+            float drift = wrapDegrees(now - _restHeading);
+            turnOrigin(drift);
+            _driftRate += 0.02f * (drift / dt - _driftRate);
+            if (_driftRate > maxDriftRate) {
+                _driftRate = maxDriftRate;
+            } else if (_driftRate < -maxDriftRate) {
+                _driftRate = -maxDriftRate;
+            }
+        }
+        _restHeading = now;
+        _hasRestHeading = true;
+    }
+
+    bool calibrated() const { return _calibrated; }
+
+    // The origin orientation, turned by the drift seen so far.
+    const myo::Quaternion<float>& origin() const { return _origin; }
+
+    // The origin's Euler yaw in degrees, -180 to 180, including the drift seen so far.
+    float originYaw() const { return _originHeading; }
+
+    // Estimated drift in deg/s, and the total drift corrected since calibration in degrees.
+    float driftRate() const { return _driftRate; }
+    float driftTotal() const { return _driftTotal; }
+
+    // Whether the last sample was part of a rest period.
+    bool atRest() const { return _hasRestHeading; }
+
+private:
+    // The drift estimate can't be more than this, so a misread rest can't send the kit spinning.
+    static const int maxDriftRate = 2;
+
+    static float wrapDegrees(float degrees)
+    {
+        while (degrees > 180) {
+            degrees -= 360;
+        }
+        while (degrees <= -180) {
+            degrees += 360;
+        }
+        return degrees;
+    }
+
+    // Heading of the forearm about the world vertical, in degrees: the Euler yaw.
+    static float heading(const myo::Quaternion<float>& orientation)
+    {
+        myo::Vector3<float> forward = myo::rotate(orientation, myo::Vector3<float>(1, 0, 0));
+        return std::atan2(forward.y(), forward.x()) * 180.0f / static_cast<float>(M_PI);
+    }
+
+    // Turn the origin about the world vertical by \a degrees.
+    void turnOrigin(float degrees)
+    {
+        if (degrees == 0) {
+            return;
+        }
+        float radians = degrees * static_cast<float>(M_PI) / 180.0f;
+        _origin = (myo::Quaternion<float>::fromAxisAngle(myo::Vector3<float>(0, 0, 1), radians) * _origin).normalized();
+        _originHeading = wrapDegrees(_originHeading + degrees);
+        _driftTotal += degrees;
+    }
+
+    float _restRate;
+    uint64_t _restTime;
+    bool _calibrated;
+    myo::Quaternion<float> _origin;
+    float _originHeading;
+    float _driftRate;
+    float _driftTotal;
+    uint64_t _lastTimestamp;
+    uint64_t _stillSince;
+    bool _still;
+    bool _hasRestHeading;
+    float _restHeading;
+};
@@ -0,0 +1,518 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "../include/myo/myo.hpp"
+#include "AsyncLog.hpp"
+#include "Calibration.hpp"
+#include "DeviceColumn.hpp"
+#include "DeviceRegistry.hpp"
+#include "DrumKit.hpp"
+#include "FastTrig.hpp"
+#include "LatencyProbe.hpp"
+#include "Metrics.hpp"
+#include "OrientationFilter.hpp"
+#include "StrikeDetector.hpp"
+#include "ZoneMap.hpp"
+
+// Returns yaw value \a cv relative to the origin \a no, wrapped into 0 to 359 degrees.
+inline int correction(int cv, int no) {
+	if (cv >= no) {
+		return cv - no;
+	}
+	else {
+		return cv + (360 - no);
+	}
+}
+
+// Classes that inherit from myo::DeviceListener can be used to receive events from Myo devices. DeviceListener
+// provides several virtual functions for handling different kinds of events. If you do not override an event, the
+// default behavior is to do nothing.
+//
+// Trig is where the Euler angles' atan2 and asin come from: LibmTrig, or PolynomialTrig, which is faster and still
+// within 0.004 degrees, far less than the whole degree the angles are rounded to. TrigBench compares the two.
+//
+// Probe is told as each event passes a LatencyStage; LatencyBench times the stages with it. The default probe does
+// nothing.
+//
+// Any number of armbands can be played at once. Each gets a dense index, in the order they were first seen, and its
+// state is a slot at that index in every DeviceColumn below. armOf() says which arm's zones it plays.
+template <typename Trig = LibmTrig, typename Probe = NoLatencyProbe>
+class DataCollector : public myo::DeviceListener {
+public:
+    // With \a gyroStrikes set, hits are found from the gyroscope's angular velocity (see StrikeDetector); otherwise
+    // from the pitch angle crossing fixed thresholds. With \a directionZones set, the zone is found from the
+    // direction the arm points in rather than from its Euler angles.
+    DataCollector(DrumKit& kit, bool gyroStrikes = true, bool directionZones = false)
+		:kit(kit), gyroStrikes(gyroStrikes), directionZones(directionZones), fusion(false), fusionLead(0), metrics(0), log(0), strikes(0),
+		motionIndex(DeviceRegistry<myo::Myo>::notFound)
+    {
+    }
+
+	void onPair(myo::Myo* myo, uint64_t timestamp, myo::FirmwareVersion firmwareVersion)
+	{
+		// Print out the MAC address of the armband we paired with.
+
+		// The pointer address we get for a Myo is unique - in other words, it's safe to compare two Myo pointers to
+		// see if they're referring to the same Myo.
+
+		// identifyMyo() adds the Myo pointer to our list of known Myo devices the first time it sees it, giving each Myo
+		// a nice short identifier. An armband that pairs again keeps the one it had.
+		LogLine line;
+		line << "Paired with " << identifyMyo(myo) << ".\n";
+		writeLog(log, line);
+	}
+
+    // onUnpair() is called whenever the Myo is disconnected from Myo Connect by the user.
+	void onUnpair(myo::Myo* myo, uint64_t timestamp)
+	{
+		// We've lost a Myo.
+		// Let's clean up its leftover state; the other armbands play on.
+		resetArmband(identifyMyo(myo));
+    }
+
+    // onOrientationData() is called whenever the Myo device provides its current orientation, which is represented
+    // as a unit quaternion.
+    void onOrientationData(myo::Myo* myo, uint64_t timestamp, const myo::Quaternion<float>& quat)
+    {
+		size_t myoIndex = identifyMyo(myo);
+		motionIndex = myoIndex;
+		probe.event(myoIndex, timestamp);
+		ScopedTimer timer(metrics ? &metrics->callbacks : 0);
+		if (metrics) {
+			metrics->sample(myoIndex, timestamp);
+		}
+
+		//std::cout << "w: " << quat.w() << " x: " << quat.x() << " y: " << quat.y() << " z: " << quat.z() << "\n";
+		// Keep the raw orientation; onGyroscopeData() for the same event needs it.
+		orientation[myoIndex] = quat;
+		
+		// The first sample after pairing, or after a fist, sets the origin.
+		if (!calibration[myoIndex].calibrated())
+		{
+			updateEulerAngles(myoIndex);
+			origin_roll[myoIndex] = roll_w[myoIndex];
+			origin_pitch[myoIndex] = pitch_w[myoIndex];
+			origin_yaw[myoIndex] = yaw_w[myoIndex];
+			calibration[myoIndex].calibrate(quat);
+		}
+
+		// Test for a strike on every sample, so the drum sounds in the same callback that saw the stick come down.
+		// Strikes from the gyroscope don't need the Euler angles until one fires.
+		if (!gyroStrikes) {
+			updateEulerAngles(myoIndex);
+			probe.mark(stageOriented);
+			detectStrike(myoIndex, timestamp);
+		}
+    }
+
+	// Set roll_w, pitch_w and yaw_w from the latest orientation of \a myoIndex (see currentOrientation()).
+	void updateEulerAngles(size_t myoIndex)
+	{
+        using std::max;
+        using std::min;
+
+		myo::Quaternion<float> quat = currentOrientation(myoIndex);
+
+        // Calculate Euler angles (roll, pitch, and yaw) from the unit quaternion.
+        float roll = Trig::atan2(2.0f * (quat.w() * quat.x() + quat.y() * quat.z()),
+                           1.0f - 2.0f * (quat.x() * quat.x() + quat.y() * quat.y()));
+		float pitch = Trig::asin(max(-1.0f, min(1.0f, 2.0f * (quat.w() * quat.y() - quat.z() * quat.x()))));
+		float yaw = Trig::atan2(2.0f * (quat.w() * quat.z() + quat.x() * quat.y()),
+                        1.0f - 2.0f * (quat.y() * quat.y() + quat.z() * quat.z()));
+
+        // Convert the floating point angles in radians to a scale from 0 to 359.
+        roll_w[myoIndex] = static_cast<int>((roll + (float)M_PI)/(M_PI * 2.0f) * 359);
+        pitch_w[myoIndex] = static_cast<int>((pitch + (float)M_PI/2.0f)/M_PI * 359);
+        yaw_w[myoIndex] = static_cast<int>((yaw + (float)M_PI)/(M_PI * 2.0f) * 359);
+	}
+
+	// Fuse the orientation filters with the armband's orientation and extrapolate \a lead seconds ahead, so that the
+	// zone of a strike is taken from where the arm is when the drum sounds rather than from a smoothed past sample.
+	void enableFusion(float lead)
+	{
+		fusion = true;
+		fusionLead = lead;
+		for (size_t i = 0; i < filters.size(); i++) {
+			filters[i].setLead(lead);
+		}
+	}
+
+	// Keep count of samples, strikes and time spent in \a metrics, which must outlive the collector, or stop if it is 0.
+	// Must be called from the thread the collector's events arrive on.
+	void useMetrics(CollectorMetrics* metrics)
+	{
+		this->metrics = metrics;
+	}
+
+	// Print through \a log, which must outlive the collector, instead of straight to std::cout, or stop if it is 0.
+	// The log must be written to from the thread the collector's events arrive on.
+	void useLog(AsyncLog* log)
+	{
+		this->log = log;
+	}
+
+	// The orientation zones and angles are taken from: the filter's prediction with fusion on, else the armband's.
+	myo::Quaternion<float> currentOrientation(size_t myoIndex) const
+	{
+		if (fusion && filters[myoIndex].initialized()) {
+			return filters[myoIndex].predicted();
+		}
+		return orientation[myoIndex];
+	}
+
+    // onAccelerometerData() is called between onOrientationData() and onGyroscopeData() for the same sample, in g.
+    void onAccelerometerData(myo::Myo* myo, uint64_t timestamp, const myo::Vector3<float>& accel)
+    {
+		acceleration[motionArmband(myo)] = accel;
+    }
+
+    // onGyroscopeData() is called right after onOrientationData() for the same sample, with the angular velocity in
+    // deg/s. The velocity peaks before the pitch has moved far, so strikes found here fire several samples earlier.
+    void onGyroscopeData(myo::Myo* myo, uint64_t timestamp, const myo::Vector3<float>& gyro)
+    {
+		size_t myoIndex = motionArmband(myo);
+		ScopedTimer timer(metrics ? &metrics->callbacks : 0);
+		if (fusion) {
+			filters[myoIndex].update(timestamp, orientation[myoIndex], acceleration[myoIndex], gyro);
+		}
+
+		// Keep the origin's heading following the armband's yaw drift.
+		if (calibration[myoIndex].calibrated()) {
+			calibration[myoIndex].update(timestamp, orientation[myoIndex], gyro);
+			origin_yaw[myoIndex] = static_cast<int>((calibration[myoIndex].originYaw() + 180.0f) / 360.0f * 359);
+		}
+		if (!gyroStrikes) {
+			return;
+		}
+		probe.mark(stageOriented);
+
+		Strike strike;
+		if (strikeDetectors[myoIndex].update(timestamp, downwardPitchRate(orientation[myoIndex], gyro), strike)) {
+			fireStrike(myoIndex, strike);
+		}
+    }
+
+	// A strike is the pitch rising more than 45 degrees above the origin, which arms the arm, and then falling back
+	// below 40 degrees, which fires it.
+	void detectStrike(size_t myoIndex, uint64_t timestamp)
+	{
+		if (pitch_w[myoIndex] - origin_pitch[myoIndex] > 45) {
+			allowedSound[myoIndex] = true;
+		}
+		if (pitch_w[myoIndex] - origin_pitch[myoIndex] < 40 && allowedSound[myoIndex]) {
+			Strike strike = { timestamp, 0 };
+			fireStrike(myoIndex, strike);
+			allowedSound[myoIndex] = false;
+		}
+	}
+
+	// Play the drum in the zone the arm is currently pointing at.
+	void fireStrike(size_t myoIndex, const Strike& strike)
+	{
+		strikes++;
+		probe.mark(stageStruck);
+		if (gyroStrikes) {
+			updateEulerAngles(myoIndex);
+		}
+		int c_yaw = correction(yaw_w[myoIndex], origin_yaw[myoIndex]);
+		// pitch_w spans -90 to 90 degrees in 359 steps.
+		int c_pitch = (pitch_w[myoIndex] - origin_pitch[myoIndex]) * 180 / 359;
+		printArm(myoIndex);
+		LogLine line;
+		line << " --------- ";
+		nameArm(line, myoIndex);
+		line << " c_yaw: " << c_yaw << " c_pitch: " << c_pitch << " velocity: " << strike.velocity << "\n";
+		writeLog(log, line);
+		const Zone* zone;
+		if (directionZones) {
+			zone = kit.findZone(armOf(myoIndex), armDirection(currentOrientation(myoIndex), calibration[myoIndex].origin()));
+		}
+		else {
+			zone = kit.findZone(armOf(myoIndex), c_yaw, c_pitch);
+		}
+		probe.mark(stageZoned);
+		if (metrics) {
+			metrics->strike(armOf(myoIndex), zone ? zone->number : 0);
+		}
+		kit.playZone(zone, strike);
+		probe.mark(stageTriggered);
+	}
+
+    // onPose() is called whenever the Myo detects that the person wearing it has changed their pose, for example,
+    // making a fist, or not making a fist anymore.
+    void onPose(myo::Myo* myo, uint64_t timestamp, myo::Pose pose)
+    {
+		size_t myoIndex = identifyMyo(myo);
+        currentPose[myoIndex] = pose;
+
+        /*if (pose != myo::Pose::unknown && pose != myo::Pose::rest) {
+            // Tell the Myo to stay unlocked until told otherwise. We do that here so you can hold the poses without the
+            // Myo becoming locked.
+            myo->unlock(myo::Myo::unlockHold);
+
+            // Notify the Myo that the pose has resulted in an action, in this case changing
+            // the text on the screen. The Myo will vibrate.
+            myo->notifyUserAction();
+        } else {
+            // Tell the Myo to stay unlocked only for a short period. This allows the Myo to stay unlocked while poses
+            // are being performed, but lock after inactivity.
+            myo->unlock(myo::Myo::unlockTimed);
+        }*/
+		LogLine line;
+		line << pose.toString().c_str();
+		// Drift is corrected as the arms rest, so a fist is only needed to move the kit somewhere else: it takes a
+		// new origin from the next sample.
+		if (pose == myo::Pose::fist)
+		{
+			line << "fist";
+			calibration[myoIndex].reset();
+		}
+		writeLog(log, line);
+    }
+
+    // onArmSync() is called whenever Myo has recognized a Sync Gesture after someone has put it on their
+    // arm. This lets Myo know which arm it's on and which way it's facing.
+    void onArmSync(myo::Myo* myo, uint64_t timestamp, myo::Arm arm, myo::XDirection xDirection, float rotation,
+                   myo::WarmupState warmupState)
+    {
+		size_t myoIndex = identifyMyo(myo);
+        onArm[myoIndex] = true;
+        whichArm[myoIndex] = arm;
+    }
+
+    // onArmUnsync() is called whenever Myo has detected that it was moved from a stable position on a person's arm after
+    // it recognized the arm. Typically this happens when someone takes Myo off of their arm, but it can also happen
+    // when Myo is moved around on the arm.
+    void onArmUnsync(myo::Myo* myo, uint64_t timestamp)
+    {
+		size_t myoIndex = identifyMyo(myo);
+        onArm[myoIndex] = false;
+    }
+
+    // onUnlock() is called whenever Myo has become unlocked, and will start delivering pose events.
+    void onUnlock(myo::Myo* myo, uint64_t timestamp)
+    {
+		size_t myoIndex = identifyMyo(myo);
+        isUnlocked[myoIndex] = true;
+    }
+
+    // onLock() is called whenever Myo has become locked. No pose events will be sent until the Myo is unlocked again.
+    void onLock(myo::Myo* myo, uint64_t timestamp)
+    {
+		size_t myoIndex = identifyMyo(myo);
+        isUnlocked[myoIndex] = false;
+    }
+
+    // There are other virtual functions in DeviceListener that we could override here, like onAccelerometerData().
+    // For this example, the functions overridden above are sufficient.
+
+    // We define this function to print the current values that were updated by the on...() functions above.
+    void print()
+    {
+		for (size_t i = 0; i < knownMyos.size(); i++)
+		{
+			// Clear the current line
+			LogLine line;
+			line << '\n';
+
+			// Print out the orientation. Orientation data is always available, even if no arm is currently recognized.
+			/*std::cout << "[ Roll: " << std::roll_w, '*') << std::string(18 - roll_w, ' ') << ']'
+			<< "[ Pitch: " << std::string(pitch_w, '*') << std::string(18 - pitch_w, ' ') << ']'
+			<< "[ Yaw : " << std::string(yaw_w, '*') << std::string(18 - yaw_w, ' ') << ']';
+			*/
+			line << i << "[ Roll: " << roll_w[i] << "] [ Pitch: " << pitch_w[i] << " ] [ Yaw: " << yaw_w[i] << " ]";
+		
+			if (onArm[i]){
+				// Print out the lock state, the currently recognized pose, and which arm Myo is being worn on.
+
+				// Pose::toString() provides the human-readable name of a pose. We can also output a Pose directly to an
+				// output stream (e.g. std::cout << currentPose;). In this case we want to get the pose name's length so
+				// that we can fill the rest of the field with spaces below, so we obtain it as a string using toString().
+				std::string poseString = currentPose[i].toString();
+
+				/*std::cout << '[' << (isUnlocked[i] ? "unlocked" : "locked  ") << ']'
+					<< '[' << (whichArm[i] == myo::armLeft ? "L" : "R") << ']'
+					<< '[' << poseString << std::string(14 - poseString.size(), ' ') << ']';*/
+			}
+			else {
+				// Print out a placeholder for the arm and pose when Myo doesn't currently know which arm it's on.
+				line << "[        ][?][              ]";
+			}
+			writeLog(log, line);
+		}
+		LogLine end;
+		end << "\n";
+		writeLog(log, end);
+    }
+
+	// Print the angles of armband \a myoIndex, named by the arm it plays.
+	void printArm(size_t myoIndex)
+	{
+		// Clear the current line
+		LogLine line;
+		line << '\n';
+		nameArm(line, myoIndex);
+		line << " Arm: [ Roll: " << roll_w[myoIndex] << "] [ Pitch: " << pitch_w[myoIndex] << " ] [ Yaw: "
+		     << yaw_w[myoIndex] << " ]";
+		writeLog(log, line);
+	}
+	void printRight()
+	{
+		printArm(0);
+	}
+	void printLeft()
+	{
+		printArm(1);
+	}
+
+	// The armband's index, counting from 0 in the order armbands were first seen. An armband seen for the first time
+	// is given the next index, whether or not its pairing was seen.
+	size_t identifyMyo(myo::Myo* myo) {
+		// If two Myo pointers compare equal, they refer to the same Myo device, so the pointer is looked up in the
+		// registry of Myo devices that we've seen events for.
+		size_t myoIndex = knownMyos.find(myo);
+		if (myoIndex != DeviceRegistry<myo::Myo>::notFound) {
+			return myoIndex;
+		}
+
+		return addArmband(myo);
+	}
+
+	// The index of \a myo during the accelerometer and gyroscope callbacks of a motion event. Those come straight after
+	// the event's onOrientationData(), which looked the armband up, so the index it found is reused when the pointer
+	// matches, and the registry is only searched once per event.
+	size_t motionArmband(myo::Myo* myo)
+	{
+		if (motionIndex < knownMyos.size() && knownMyos.device(motionIndex) == myo) {
+			return motionIndex;
+		}
+		return identifyMyo(myo);
+	}
+
+	// Give \a myo the next index and a slot in every column, and return the index.
+	size_t addArmband(myo::Myo* myo)
+	{
+		OrientationFilter filter;
+		if (fusion) {
+			filter.setLead(fusionLead);
+		}
+		size_t myoIndex = knownMyos.add(myo);
+		filters.push_back(filter);
+		acceleration.push_back(myo::Vector3<float>());
+		allowedSound.push_back(false);
+		strikeDetectors.push_back(StrikeDetector());
+		orientation.push_back(myo::Quaternion<float>());
+		calibration.push_back(Calibration());
+		onArm.push_back(false);
+		whichArm.push_back(myo::armUnknown);
+		isUnlocked.push_back(false);
+		roll_w.push_back(0);
+		pitch_w.push_back(0);
+		yaw_w.push_back(0);
+		origin_roll.push_back(0);
+		origin_pitch.push_back(0);
+		origin_yaw.push_back(0);
+		currentPose.push_back(myo::Pose());
+		return myoIndex;
+	}
+
+	// Forget everything armband \a myoIndex has told us, as if it had just been seen for the first time. It keeps its
+	// index.
+	void resetArmband(size_t myoIndex)
+	{
+		roll_w[myoIndex] = 0;
+		pitch_w[myoIndex] = 0;
+		yaw_w[myoIndex] = 0;
+		origin_roll[myoIndex] = 0;
+		origin_pitch[myoIndex] = 0;
+		origin_yaw[myoIndex] = 0;
+		onArm[myoIndex] = false;
+		whichArm[myoIndex] = myo::armUnknown;
+		isUnlocked[myoIndex] = false;
+		allowedSound[myoIndex] = false;
+		strikeDetectors[myoIndex].reset();
+		filters[myoIndex].reset();
+		calibration[myoIndex].reset();
+	}
+
+	// The arm whose zones armband \a myoIndex plays: the one it synced to, else the one its pairing order gives.
+	DrumKit::Arm armOf(size_t myoIndex) const
+	{
+		return DrumKit::armOf(myoIndex, whichArm[myoIndex]);
+	}
+
+	// "Right" or "Left", for the arm armband \a myoIndex plays, followed by its index once there are more armbands
+	// than arms.
+	void nameArm(LogLine& line, size_t myoIndex) const
+	{
+		line << (armOf(myoIndex) == DrumKit::rightArm ? "Right" : "Left");
+		if (myoIndex >= ZoneMap::armCount) {
+			line << ' ' << myoIndex;
+		}
+	}
+
+	// We store each Myo pointer that we've seen in this registry, so that we can keep track of the order we've seen
+	// each Myo and give it a unique short identifier (see identifyMyo() above). Every DeviceColumn below has one slot
+	// per entry.
+	DeviceRegistry<myo::Myo> knownMyos;
+
+	// Strikes detected by onOrientationData() are played on this kit.
+	DrumKit& kit;
+
+	// Selects onGyroscopeData() or detectStrike() as the source of strikes.
+	bool gyroStrikes;
+
+	// Selects armDirection() or the Euler angles for finding the zone of a strike.
+	bool directionZones;
+
+	// Set by enableFusion(); the filters are fed by onGyroscopeData() with the sample's orientation and acceleration.
+	bool fusion;
+	float fusionLead;
+	DeviceColumn<OrientationFilter> filters;
+	DeviceColumn<myo::Vector3<float> > acceleration;
+
+	// Set by useMetrics(); 0 when no metrics are kept.
+	CollectorMetrics* metrics;
+
+	// Set by useLog(); 0 to print straight to std::cout.
+	AsyncLog* log;
+
+	// Number of strikes fired since the collector was made.
+	uint64_t strikes;
+
+	// The armband of the latest onOrientationData(), for motionArmband().
+	size_t motionIndex;
+
+	// Marked as each event passes a LatencyStage.
+	Probe probe;
+
+	// Set by detectStrike() once an arm has been raised far enough for the next downswing to count as a strike.
+	DeviceColumn<uint8_t> allowedSound;
+
+	// Used by onGyroscopeData() to find strikes from angular velocity.
+	DeviceColumn<StrikeDetector> strikeDetectors;
+	DeviceColumn<myo::Quaternion<float> > orientation;
+
+	// The origin each arm's angles are measured from, kept in step with yaw drift by onGyroscopeData().
+	DeviceColumn<Calibration> calibration;
+
+    // These values are set by onArmSync() and onArmUnsync() above. whichArm keeps the last synced arm through an
+    // unsync, until the armband syncs again or unpairs.
+	DeviceColumn<uint8_t> onArm;
+	DeviceColumn<myo::Arm> whichArm;
+
+    // This is set by onUnlocked() and onLocked() above.
+	DeviceColumn<uint8_t> isUnlocked;
+
+    // These values are set by onOrientationData() and onGyroscopeData() above.
+	DeviceColumn<int> roll_w, pitch_w, yaw_w;
+	DeviceColumn<int> origin_roll, origin_pitch, origin_yaw;
+	DeviceColumn<myo::Pose> currentPose;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <new>
+#include <stddef.h>
+#include <stdlib.h>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+// An allocator whose blocks start on a cache line, so the first elements of an array never share a line with
+// whatever was allocated before it.
+template <typename T>
+class CacheAlignedAllocator {
+public:
+    typedef T value_type;
+
+    static const size_t alignment = 64;
+
+    CacheAlignedAllocator() {}
+
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(size_t count)
+    {
+        void* block = 0;
+#if defined(_MSC_VER)
+        block = _aligned_malloc(count * sizeof(T), alignment);
+#else
+        if (posix_memalign(&block, alignment, count * sizeof(T)) != 0) {
+            block = 0;
+        }
+#endif
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(block);
+    }
+
+    void deallocate(T* block, size_t)
+    {
+#if defined(_MSC_VER)
+        _aligned_free(block);
+#else
+        free(block);
+#endif
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const CacheAlignedAllocator<T>&, const CacheAlignedAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator!=(const CacheAlignedAllocator<T>&, const CacheAlignedAllocator<U>&) { return false; }
+
+// One field of per-armband state, indexed by the armband's dense device index. A collector keeps one column per field
+// rather than one struct per armband, so a pass over one field of every armband reads consecutive cache lines and
+// nothing else. Columns grow together as armbands are added.
+//
+// std::vector<bool> packs its elements into bits, so flags are kept a byte each, as DeviceColumn<uint8_t>.
+template <typename T>
+using DeviceColumn = std::vector<T, CacheAlignedAllocator<T> >;
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// DeviceRegistry gives each device, known only by its pointer, a dense index: 0 for the first added, 1 for the next
+// and so on. Indices are never reused or taken back. The index of a pointer is found with a small open-addressing
+// hash table, kept at most half full, so looking one up costs the same with two armbands or twenty. The pointers are
+// only compared, never followed.
+template <typename Device>
+class DeviceRegistry {
+public:
+    static const size_t notFound = size_t(-1);
+
+    DeviceRegistry()
+    : _slots(minSlots, 0)
+    {
+    }
+
+    size_t size() const { return _devices.size(); }
+
+    // The device given index \a index.
+    Device* device(size_t index) const { return _devices[index]; }
+
+    // The index of \a device, or notFound if it was never added.
+    size_t find(const Device* device) const
+    {
+        size_t mask = _slots.size() - 1;
+        for (size_t slot = hash(device) & mask;; slot = (slot + 1) & mask) {
+            uint32_t entry = _slots[slot];
+            if (entry == 0) {
+                return notFound;
+            }
+            if (_devices[entry - 1] == device) {
+                return entry - 1;
+            }
+        }
+    }
+
+    // The index of \a device, which is given the next one if it was never added.
+    size_t add(Device* device)
+    {
+        size_t index = find(device);
+        if (index != notFound) {
+            return index;
+        }
+        _devices.push_back(device);
+        if (_devices.size() * 2 > _slots.size()) {
+            rehash(_slots.size() * 2);
+        } else {
+            insert(_devices.size() - 1);
+        }
+        return _devices.size() - 1;
+    }
+
+    // Forget every device; the next one added is given index 0 again.
+    void clear()
+    {
+        _devices.clear();
+        _slots.assign(minSlots, 0);
+    }
+
+private:
+    static const size_t minSlots = 16;
+
+    // Fibonacci hashing: the multiply spreads pointers that differ only in a few middle bits, as heap addresses do,
+    // over the high bits that are kept.
+    static size_t hash(const Device* device)
+    {
+        uint64_t h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(device)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> 32);
+    }
+
+    void insert(size_t index)
+    {
+        size_t mask = _slots.size() - 1;
+        size_t slot = hash(_devices[index]) & mask;
+        while (_slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        _slots[slot] = static_cast<uint32_t>(index + 1);
+    }
+
+    void rehash(size_t slotCount)
+    {
+        _slots.assign(slotCount, 0);
+        for (size_t i = 0; i < _devices.size(); i++) {
+            insert(i);
+        }
+    }
+
+    std::vector<Device*> _devices;
+
+    // A power of two of slots, each 0 if empty, else one more than the index of a device.
+    std::vector<uint32_t> _slots;
+};
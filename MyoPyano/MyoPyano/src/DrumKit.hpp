@@ -0,0 +1,329 @@
+#pragma once
+
+#include <iostream>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "../include/irrKlang/irrKlang.h"
+#include "AsyncLog.hpp"
+#include "Mixer.hpp"
+#include "Polyphony.hpp"
+#include "SampleBank.hpp"
+#include "StrikeDetector.hpp"
+#include "ZoneMap.hpp"
+
+// Map a strike velocity in deg/s to a playback volume between \a minGain and 1. Strikes of unknown velocity (zero)
+// play at full volume. The square gives soft hits a wider range than hard ones, which is closer to how loudness is
+// heard than a straight line.
+inline float velocityToGain(float velocity, float minVelocity = 150.0f, float maxVelocity = 1200.0f,
+                            float minGain = 0.15f)
+{
+    if (velocity <= 0) {
+        return 1.0f;
+    }
+    float t = (velocity - minVelocity) / (maxVelocity - minVelocity);
+    if (t < 0) {
+        t = 0;
+    } else if (t > 1) {
+        t = 1;
+    }
+    return minGain + (1.0f - minGain) * t * t;
+}
+
+// DrumKit maps a strike to a drum and plays it. A Myo plays the arm it reported at arm sync; until then the first Myo
+// that paired is played as the right arm, the second as the left arm, the third as the right arm again and so on.
+// Each arm has its own ZoneMap zones, regions of yaw and pitch relative to the calibrated origin, and the zone the
+// stick came down in picks the drum.
+//
+// At most voiceCount hits ring at once. Each pad also has its own voice limit and may choke others, so a fast roll
+// reuses the pad's oldest voice instead of stacking more and more copies of the same sample.
+class DrumKit {
+public:
+    static const size_t voiceCount = 16;
+
+    enum PadId {
+        crash,
+        snare,
+        tom1,
+        tom2,
+        floorTom,
+        hiHat,
+        hiHatClosed,
+        bass,
+        padCount
+    };
+
+    // The arms, as indices into zones.
+    enum Arm {
+        rightArm,
+        leftArm
+    };
+
+    // Choke groups, see VoiceLimits.
+    static const unsigned int hiHatGroup = 1;
+
+    // A drum and the sound it plays. Pan places it in the stereo field as seen from the drummer's seat.
+    struct Pad {
+        const char* name;
+        const char* fileName;
+        float pan;
+        VoiceLimits limits;
+        SampleHandle sample;
+    };
+
+    // Pads play samples from \a bank; any the bank doesn't have yet are loaded into it here. \a engine may be 0, for
+    // a kit that only ever plays through a mixer (see useMixer()); \a bank then has no engine either.
+    DrumKit(irrklang::ISoundEngine* engine, SampleBank& bank, VoiceStealing stealing = stealOldest)
+    : engine(engine)
+    , bank(&bank)
+    , mixer(0)
+    , log(0)
+    , stealing(stealing)
+    , hits(0)
+    {
+        // The closed hi-hat chokes the open one, as the pedal does on a real kit.
+        static const Pad layout[padCount] = {
+            { "Cymbals",    "Sounds/crash_cymbals.wav",  0.4f, VoiceLimits(3),                         SampleBank::invalidHandle },
+            { "Snare",      "Sounds/909_snr2.wav",       0.0f, VoiceLimits(4),                         SampleBank::invalidHandle },
+            { "Tom 1",      "Sounds/tom1.wav",          -0.2f, VoiceLimits(3),                         SampleBank::invalidHandle },
+            { "Tom 2",      "Sounds/tom2.wav",           0.2f, VoiceLimits(3),                         SampleBank::invalidHandle },
+            { "Floor Tom",  "Sounds/tomfloor.wav",       0.5f, VoiceLimits(3),                         SampleBank::invalidHandle },
+            { "High Hat",   "Sounds/hh4.wav",           -0.5f, VoiceLimits(2, hiHatGroup),             SampleBank::invalidHandle },
+            { "Closed Hat", "Sounds/hhclosed.wav",      -0.5f, VoiceLimits(2, hiHatGroup, hiHatGroup), SampleBank::invalidHandle },
+            { "Bass",       "Sounds/bassdr04.wav",       0.0f, VoiceLimits(2),                         SampleBank::invalidHandle },
+        };
+
+        for (int i = 0; i < padCount; i++) {
+            pads[i] = layout[i];
+        }
+
+        // Zones per arm, in degrees clockwise from the calibrated origin, at any pitch. A layout file can replace
+        // them; see loadLayout().
+        static const Zone rightZones[] = {
+            { 1, crash,     35, 150, ZoneMap::minPitch, ZoneMap::maxPitch },
+            { 2, snare,    320,  35, ZoneMap::minPitch, ZoneMap::maxPitch },
+            { 3, tom2,     260, 320, ZoneMap::minPitch, ZoneMap::maxPitch },
+            { 4, floorTom, 150, 260, ZoneMap::minPitch, ZoneMap::maxPitch },
+        };
+        static const Zone leftZones[] = {
+            { 4, hiHat,     90, 260, ZoneMap::minPitch, ZoneMap::maxPitch },
+            { 3, snare,     40,  90, ZoneMap::minPitch, ZoneMap::maxPitch },
+            { 2, tom1,     320,  40, ZoneMap::minPitch, ZoneMap::maxPitch },
+            { 1, bass,     260, 320, ZoneMap::minPitch, ZoneMap::maxPitch },
+        };
+        zones.setZones(rightArm, rightZones, sizeof(rightZones) / sizeof(rightZones[0]));
+        zones.setZones(leftArm, leftZones, sizeof(leftZones) / sizeof(leftZones[0]));
+
+        for (size_t v = 0; v < voiceCount; v++) {
+            sounds[v] = 0;
+        }
+        resolvePads();
+    }
+
+    ~DrumKit()
+    {
+        for (size_t v = 0; v < voiceCount; v++) {
+            if (sounds[v]) {
+                sounds[v]->drop();
+            }
+        }
+    }
+
+    // Switch to the samples of another kit. Only the pad handles change; nothing is opened or loaded unless \a bank
+    // is missing one of the pads' samples, and with a mixer nothing is converted unless a sample has never been
+    // added to it. The bank must outlive the kit. Must be called from the thread that calls strike().
+    void useBank(SampleBank& bank)
+    {
+        this->bank = &bank;
+        resolvePads();
+    }
+
+    // Play through \a mixer instead of irrKlang's own voices, or through irrKlang again if it is 0. The pads'
+    // samples are copied into the mixer here, the first time each is used with it. Must be called from the thread
+    // that calls strike().
+    void useMixer(Mixer* mixer)
+    {
+        this->mixer = mixer;
+        resolvePads();
+    }
+
+    // Print the zones played through \a log instead of straight to std::cout, or through std::cout again if it is 0.
+    // The log must be written to from the thread that calls strike().
+    void useLog(AsyncLog* log)
+    {
+        this->log = log;
+    }
+
+    // The names a zone layout file uses for the pads, indexed by PadId.
+    static const char* const* padKeys()
+    {
+        static const char* const keys[padCount] = {
+            "crash", "snare", "tom1", "tom2", "floorTom", "hiHat", "hiHatClosed", "bass"
+        };
+        return keys;
+    }
+
+    // Replace the zones of the arms that the layout file \a fileName describes (see loadZoneLayout()). Returns false
+    // with a message in \a error, leaving the zones as they were, if the file can't be used.
+    bool loadLayout(const std::string& fileName, std::string& error)
+    {
+        return loadZoneLayout(fileName, padKeys(), padCount, zones, error);
+    }
+
+    // Play the drum for \a strike by \a arm at corrected yaw \a c_yaw (0 to 359 degrees) and pitch \a c_pitch
+    // (-90 to 90 degrees, up is positive).
+    void strike(Arm arm, int c_yaw, int c_pitch, const Strike& strike)
+    {
+        playZone(findZone(arm, c_yaw, c_pitch), strike);
+    }
+
+    // Play the drum for \a strike by \a arm pointing in \a direction, as given by armDirection().
+    void strike(Arm arm, const myo::Vector3<float>& direction, const Strike& strike)
+    {
+        playZone(findZone(arm, direction), strike);
+    }
+
+    // The arm armband \a myoIndex is played as: \a syncedArm, the arm it reported at arm sync, or, while that is
+    // myo::armUnknown, the arm its pairing order gives. Unsynced armbands alternate between the arms, so an ensemble
+    // of several drummers pairs as right, left, right, left.
+    static Arm armOf(size_t myoIndex, myo::Arm syncedArm)
+    {
+        if (syncedArm == myo::armRight) {
+            return rightArm;
+        }
+        if (syncedArm == myo::armLeft) {
+            return leftArm;
+        }
+        return myoIndex % 2 == 0 ? rightArm : leftArm;
+    }
+
+    // The zone \a arm is in at corrected yaw \a c_yaw and pitch \a c_pitch, or 0 if none.
+    const Zone* findZone(Arm arm, int c_yaw, int c_pitch) const
+    {
+        return zones.find(arm, c_yaw, c_pitch);
+    }
+
+    // The zone \a arm is in pointing in \a direction, or 0 if none.
+    const Zone* findZone(Arm arm, const myo::Vector3<float>& direction) const
+    {
+        return zones.find(arm, direction);
+    }
+
+    // Play the pad of \a zone, which may be 0, for \a strike.
+    void playZone(const Zone* zone, const Strike& strike)
+    {
+        if (zone) {
+            LogLine line;
+            line << " ZONE " << zone->number << ": " << pads[zone->pad].name << "\n";
+            writeLog(log, line);
+            play(static_cast<PadId>(zone->pad), strike);
+        }
+    }
+
+    Pad pads[padCount];
+
+    // Which pad each arm plays at each yaw and pitch. Replace an arm's zones with ZoneMap::setZones() or
+    // loadLayout().
+    ZoneMap zones;
+
+
+private:
+    // Resolve every sample once, here, so a strike never has to find one by file name.
+    void resolvePads()
+    {
+        for (int i = 0; i < padCount; i++) {
+            pads[i].sample = bank->load(pads[i].fileName);
+            if (pads[i].sample == SampleBank::invalidHandle) {
+                std::cerr << "Unable to load " << pads[i].fileName << std::endl;
+            }
+            mixerSamples[i] = Mixer::invalidSample;
+            if (mixer && pads[i].sample != SampleBank::invalidHandle) {
+                mixerSamples[i] = mixerSample(pads[i].sample);
+            }
+        }
+    }
+
+    // The mixer's copy of sample \a handle of the current bank, added to the mixer only if it isn't there yet.
+    MixerSampleId mixerSample(SampleHandle handle)
+    {
+        MixerSamples* added = 0;
+        for (size_t i = 0; i < mixerCache.size(); i++) {
+            if (mixerCache[i].mixer == mixer && mixerCache[i].bank == bank) {
+                added = &mixerCache[i];
+                break;
+            }
+        }
+        if (!added) {
+            MixerSamples samples = { mixer, bank, std::vector<MixerSampleId>() };
+            mixerCache.push_back(samples);
+            added = &mixerCache.back();
+        }
+
+        size_t index = static_cast<size_t>(handle);
+        if (index >= added->ids.size()) {
+            added->ids.resize(index + 1, MixerSampleId(Mixer::invalidSample));
+        }
+        if (added->ids[index] == Mixer::invalidSample) {
+            const WavData& data = bank->data(handle);
+            added->ids[index] = mixer->addSample(data.pcm, data.format);
+        }
+        return added->ids[index];
+    }
+
+    // Play a pad once, not looped, at a volume matching the strike velocity. The sound is started paused so volume
+    // and pan are in place before the first sample is heard.
+    void play(PadId id, const Strike& strike)
+    {
+        const Pad& pad = pads[id];
+        if (pad.sample == SampleBank::invalidHandle)
+            return;
+
+        float gain = velocityToGain(strike.velocity);
+        if (mixer) {
+            mixer->trigger(mixerSamples[id], gain, pad.pan, id, pad.limits);
+            return;
+        }
+        if (!engine) {
+            return;
+        }
+
+        // Keep a reference to every sound still playing, so it can be choked or stolen by a later hit.
+        size_t v = allocateVoice(voiceInfo, voiceCount, id, pad.limits, stealing,
+                                 [this](size_t i) { return sounds[i] && !sounds[i]->isFinished(); },
+                                 [this](size_t i) { if (sounds[i]) sounds[i]->stop(); });
+        if (sounds[v]) {
+            sounds[v]->drop();
+            sounds[v] = 0;
+        }
+
+        irrklang::ISound* sound = engine->play2D(bank->source(pad.sample), false, true, true);
+        if (sound) {
+            sound->setVolume(gain);
+            sound->setPan(pad.pan);
+            sound->setIsPaused(false);
+            sounds[v] = sound;
+            VoiceInfo info = { id, pad.limits.chokeGroup, gain, hits++ };
+            voiceInfo[v] = info;
+        }
+    }
+
+    irrklang::ISoundEngine* engine;
+    SampleBank* bank;
+    Mixer* mixer;
+    MixerSampleId mixerSamples[padCount];
+
+    // The samples already added to each mixer, by bank and sample handle, so switching kits or mixers back and
+    // forth never converts a sample twice.
+    struct MixerSamples {
+        Mixer* mixer;
+        const SampleBank* bank;
+        std::vector<MixerSampleId> ids;
+    };
+    std::vector<MixerSamples> mixerCache;
+    AsyncLog* log;
+    VoiceStealing stealing;
+    irrklang::ISound* sounds[voiceCount];
+    VoiceInfo voiceInfo[voiceCount];
+    uint64_t hits;
+};
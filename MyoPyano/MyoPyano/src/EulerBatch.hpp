@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "FastTrig.hpp"
+
+// Convert \a count unit quaternions, given as separate arrays of x, y, z and w, to roll, pitch and yaw in radians,
+// with the same formulas as DataCollector::onOrientationData(). Works four quaternions at a time with SSE2, and
+// one at a time for the rest. The angles are within the FastTrig.hpp error bounds of libm's: 2.0e-6 rad for roll
+// and yaw, 6.8e-5 rad for pitch, plus float rounding of the arguments. Output arrays may not overlap the inputs.
+inline void quaternionsToEuler(const float* x, const float* y, const float* z, const float* w, float* roll,
+                               float* pitch, float* yaw, size_t count)
+{
+    size_t i = 0;
+#if PYANO_TRIG_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 qx = _mm_loadu_ps(x + i);
+        __m128 qy = _mm_loadu_ps(y + i);
+        __m128 qz = _mm_loadu_ps(z + i);
+        __m128 qw = _mm_loadu_ps(w + i);
+        __m128 yy = _mm_mul_ps(qy, qy);
+
+        __m128 rollY = _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(qw, qx), _mm_mul_ps(qy, qz)));
+        __m128 rollX = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(qx, qx), yy)));
+        _mm_storeu_ps(roll + i, fastAtan2(rollY, rollX));
+
+        // fastAsin() clamps, which absorbs rounding just past +-1.
+        __m128 sinPitch = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qw, qy), _mm_mul_ps(qz, qx)));
+        _mm_storeu_ps(pitch + i, fastAsin(sinPitch));
+
+        __m128 yawY = _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(qw, qz), _mm_mul_ps(qx, qy)));
+        __m128 yawX = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, _mm_mul_ps(qz, qz))));
+        _mm_storeu_ps(yaw + i, fastAtan2(yawY, yawX));
+    }
+#endif
+    for (; i < count; i++) {
+        roll[i] = fastAtan2(2.0f * (w[i] * x[i] + y[i] * z[i]), 1.0f - 2.0f * (x[i] * x[i] + y[i] * y[i]));
+        pitch[i] = fastAsin(2.0f * (w[i] * y[i] - z[i] * x[i]));
+        yaw[i] = fastAtan2(2.0f * (w[i] * z[i] + x[i] * y[i]), 1.0f - 2.0f * (y[i] * y[i] + z[i] * z[i]));
+    }
+}
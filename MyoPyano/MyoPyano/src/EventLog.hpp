@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "SensorEvent.hpp"
+
+// An event log is a recording of everything myo::Hub delivered, one fixed-size record per SensorEvent, so a log can
+// be mapped and indexed directly. Layout, all integers little-endian:
+//
+//   EventLogHeader                       magic "MPEV", version, record size
+//   EventRecord[]                        in the order the events arrived, up to the end of the file
+//
+// Armbands are stored as a device number, counting from 0 in the order each first appeared in the log.
+const uint32_t eventLogVersion = 1;
+
+// Armbands a log can hold, one per value of EventRecord::device.
+const size_t eventLogMaxDevices = 256;
+
+struct EventLogHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t reserved;
+};
+
+struct EventRecord {
+    uint64_t timestamp;
+    uint8_t type;    // SensorEvent::Type
+    uint8_t device;
+    uint8_t reserved[6];
+
+    // The fields of the SensorEvent that are valid for its type, packed in the order they are declared there:
+    //   motion                  orientation[4], accel[3], gyro[3]
+    //   paired, connected       firmware[4]
+    //   armSynced               arm, xDirection, warmupState, rotation
+    //   pose                    poseType
+    //   warmupCompleted         warmupResult
+    //   emg                     emgData[8]
+    unsigned char payload[40];
+};
+
+static_assert(sizeof(EventRecord) == 56, "EventRecord must have no padding");
+
+inline EventLogHeader makeEventLogHeader()
+{
+    EventLogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "MPEV", 4);
+    header.version = eventLogVersion;
+    header.recordSize = sizeof(EventRecord);
+    return header;
+}
+
+inline bool isEventLogHeader(const EventLogHeader& header)
+{
+    return memcmp(header.magic, "MPEV", 4) == 0 && header.version == eventLogVersion &&
+           header.recordSize == sizeof(EventRecord);
+}
+
+inline EventRecord toEventRecord(const SensorEvent& event, uint8_t device)
+{
+    EventRecord record;
+    memset(&record, 0, sizeof(record));
+    record.timestamp = event.timestamp;
+    record.type = static_cast<uint8_t>(event.type);
+    record.device = device;
+
+    unsigned char* payload = record.payload;
+    switch (event.type) {
+    case SensorEvent::motion:
+        memcpy(payload, event.orientation, sizeof(event.orientation));
+        memcpy(payload + 16, event.accel, sizeof(event.accel));
+        memcpy(payload + 28, event.gyro, sizeof(event.gyro));
+        break;
+    case SensorEvent::paired:
+    case SensorEvent::connected:
+        memcpy(payload, event.firmware, sizeof(event.firmware));
+        break;
+    case SensorEvent::armSynced:
+        memcpy(payload, &event.arm, 4);
+        memcpy(payload + 4, &event.xDirection, 4);
+        memcpy(payload + 8, &event.warmupState, 4);
+        memcpy(payload + 12, &event.rotation, 4);
+        break;
+    case SensorEvent::pose:
+        memcpy(payload, &event.poseType, 4);
+        break;
+    case SensorEvent::warmupCompleted:
+        memcpy(payload, &event.warmupResult, 4);
+        break;
+    case SensorEvent::emg:
+        memcpy(payload, event.emgData, sizeof(event.emgData));
+        break;
+    }
+    return record;
+}
+
+// The SensorEvent recorded in \a record, delivered as coming from \a myo.
+inline SensorEvent fromEventRecord(const EventRecord& record, myo::Myo* myo)
+{
+    SensorEvent event = makeSensorEvent(static_cast<SensorEvent::Type>(record.type), myo, record.timestamp);
+
+    const unsigned char* payload = record.payload;
+    switch (event.type) {
+    case SensorEvent::motion:
+        memcpy(event.orientation, payload, sizeof(event.orientation));
+        memcpy(event.accel, payload + 16, sizeof(event.accel));
+        memcpy(event.gyro, payload + 28, sizeof(event.gyro));
+        break;
+    case SensorEvent::paired:
+    case SensorEvent::connected:
+        memcpy(event.firmware, payload, sizeof(event.firmware));
+        break;
+    case SensorEvent::armSynced:
+        memcpy(&event.arm, payload, 4);
+        memcpy(&event.xDirection, payload + 4, 4);
+        memcpy(&event.warmupState, payload + 8, 4);
+        memcpy(&event.rotation, payload + 12, 4);
+        break;
+    case SensorEvent::pose:
+        memcpy(&event.poseType, payload, 4);
+        break;
+    case SensorEvent::warmupCompleted:
+        memcpy(&event.warmupResult, payload, 4);
+        break;
+    case SensorEvent::emg:
+        memcpy(event.emgData, payload, sizeof(event.emgData));
+        break;
+    }
+    return event;
+}
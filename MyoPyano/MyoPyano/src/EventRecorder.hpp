@@ -0,0 +1,222 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/myo/myo.hpp"
+#include "DeviceRegistry.hpp"
+#include "EventLog.hpp"
+#include "SensorEvent.hpp"
+
+// EventRecorder is a DeviceListener that writes every event it receives to an event log (see EventLog.hpp).
+//
+// Records are appended to one of two buffers on the thread running the Hub. When that buffer fills, or has been
+// collecting for longer than the flush interval, it is handed to a writer thread and the other buffer takes over.
+// The Hub's thread never waits for the disk and never takes a lock: if the writer still has the other buffer when
+// it is needed, the events are counted as dropped instead.
+class EventRecorder : public SensorEventListener {
+public:
+    // Each buffer holds about eight seconds of orientation and EMG data from two armbands.
+    static const size_t bufferRecords = 4096;
+
+    // A partly filled buffer is handed to the writer once it holds more than \a flushInterval microseconds of
+    // events, so a crash loses little of the recording.
+    explicit EventRecorder(uint64_t flushInterval = 500000)
+    : _flushInterval(flushInterval)
+    , _file(0)
+    , _filling(0)
+    , _bufferStart(0)
+    , _running(false)
+    , _failed(false)
+    , _recorded(0)
+    , _dropped(0)
+    , _rejected(0)
+    {
+        _buffers[0].resize(bufferRecords);
+        _buffers[1].resize(bufferRecords);
+        _counts[0] = 0;
+        _counts[1] = 0;
+        _full[0] = false;
+        _full[1] = false;
+    }
+
+    ~EventRecorder()
+    {
+        close();
+    }
+
+    // Create \a fileName, write the log header and start the writer thread. Returns false if the file can't be
+    // written.
+    bool open(const std::string& fileName)
+    {
+        close();
+        _file = fopen(fileName.c_str(), "wb");
+        if (!_file) {
+            return false;
+        }
+        EventLogHeader header = makeEventLogHeader();
+        if (fwrite(&header, sizeof(header), 1, _file) != 1) {
+            fclose(_file);
+            _file = 0;
+            return false;
+        }
+        _devices.clear();
+        _filling = 0;
+        _counts[0] = 0;
+        _counts[1] = 0;
+        _failed = false;
+        _running = true;
+        _thread = std::thread(&EventRecorder::run, this);
+        return true;
+    }
+
+    // Write out everything recorded so far and close the file. Call it from the thread running the Hub, or once the
+    // Hub has stopped.
+    void close()
+    {
+        if (!_file) {
+            return;
+        }
+        if (!_full[_filling].load(std::memory_order_acquire) && _counts[_filling] > 0) {
+            submit();
+        }
+        _running.store(false, std::memory_order_release);
+        _wake.notify_one();
+        _thread.join();
+        fclose(_file);
+        _file = 0;
+    }
+
+    // Events written, or queued to be.
+    uint64_t recorded() const { return _recorded.load(std::memory_order_relaxed); }
+
+    // Events lost because the writer fell behind.
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    // Events not recorded because they came from an armband past the first eventLogMaxDevices, which a log has no
+    // device number for.
+    uint64_t rejected() const { return _rejected.load(std::memory_order_relaxed); }
+
+    // Whether writing to the file has failed; everything after the failure is lost.
+    bool failed() const { return _failed.load(std::memory_order_relaxed); }
+
+    // Called on the thread running the Hub.
+    void onSensorEvent(const SensorEvent& event)
+    {
+        if (!_file) {
+            return;
+        }
+        uint8_t device;
+        if (!deviceNumber(event.myo, device)) {
+            _rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (_full[_filling].load(std::memory_order_acquire)) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        size_t& count = _counts[_filling];
+        if (count == 0) {
+            _bufferStart = event.timestamp;
+        }
+        _buffers[_filling][count++] = toEventRecord(event, device);
+        _recorded.fetch_add(1, std::memory_order_relaxed);
+
+        // Armbands' clocks aren't in step, so an event may be stamped earlier than the buffer's first; it only counts
+        // towards the flush interval once it is later.
+        if (count == bufferRecords ||
+            (event.timestamp > _bufferStart && event.timestamp - _bufferStart >= _flushInterval)) {
+            submit();
+        }
+    }
+
+private:
+    // Hand the filling buffer to the writer and switch to the other one.
+    void submit()
+    {
+        _full[_filling].store(true, std::memory_order_release);
+        _wake.notify_one();
+        _filling ^= 1;
+    }
+
+    // Writer thread. Buffers are submitted alternately, so writing them alternately keeps the events in order.
+    void run()
+    {
+        size_t next = 0;
+        for (;;) {
+            bool stopping = !_running.load(std::memory_order_acquire);
+            if (_full[next].load(std::memory_order_acquire)) {
+                write(_buffers[next], _counts[next]);
+                _counts[next] = 0;
+                _full[next].store(false, std::memory_order_release);
+                next ^= 1;
+                continue;
+            }
+            if (stopping) {
+                break;
+            }
+            // submit() doesn't take the mutex, so a wakeup can be missed; the timeout bounds how late it is noticed.
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait_for(lock, std::chrono::milliseconds(20));
+        }
+    }
+
+    void write(const std::vector<EventRecord>& records, size_t count)
+    {
+        if (_failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (fwrite(&records[0], sizeof(EventRecord), count, _file) != count || fflush(_file) != 0) {
+            _failed.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Set \a device to the number of \a myo in the log, given the first time it's seen. Returns false if \a myo is new
+    // and every number is taken.
+    bool deviceNumber(myo::Myo* myo, uint8_t& device)
+    {
+        size_t index = _devices.find(myo);
+        if (index == DeviceRegistry<myo::Myo>::notFound) {
+            if (_devices.size() == eventLogMaxDevices) {
+                return false;
+            }
+            index = _devices.add(myo);
+        }
+        device = static_cast<uint8_t>(index);
+        return true;
+    }
+
+    uint64_t _flushInterval;
+    FILE* _file;
+    std::thread _thread;
+
+    // Each buffer belongs to the Hub's thread while its _full flag is clear, and to the writer while it is set.
+    std::vector<EventRecord> _buffers[2];
+    size_t _counts[2];
+    std::atomic<bool> _full[2];
+
+    // Only touched by the thread running the Hub.
+    size_t _filling;
+    uint64_t _bufferStart;
+    DeviceRegistry<myo::Myo> _devices;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::atomic<bool> _running;
+    std::atomic<bool> _failed;
+    std::atomic<uint64_t> _recorded;
+    std::atomic<uint64_t> _dropped;
+    std::atomic<uint64_t> _rejected;
+
+    // Not implemented
+    EventRecorder(const EventRecorder&);
+    EventRecorder& operator=(const EventRecorder&);
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+#include "../include/myo/myo.hpp"
+#include "EventLog.hpp"
+#include "MappedFile.hpp"
+#include "SensorEvent.hpp"
+
+// EventReplay plays an event log (see EventRecorder) back into a DeviceListener, through the same callbacks and in
+// the same order as myo::Hub would have, so the strike and zone logic can run without an armband.
+//
+// The log is mapped, not read, and records are decoded one at a time as they are replayed. Each recorded armband is
+// stood in for by a distinct, never dereferenced, myo::Myo pointer; listeners that only compare the pointers, like
+// DataCollector, can't tell the difference.
+class EventReplay {
+public:
+    // Armbands a log can hold, one per value of EventRecord::device.
+    static const size_t maxDevices = eventLogMaxDevices;
+
+    EventReplay()
+    : _records(0)
+    , _count(0)
+    {
+    }
+
+    // Map \a fileName. Returns false if it can't be opened or isn't an event log.
+    bool open(const std::string& fileName)
+    {
+        _records = 0;
+        _count = 0;
+        if (!_file.open(fileName) || _file.size() < sizeof(EventLogHeader)) {
+            return false;
+        }
+        EventLogHeader header;
+        memcpy(&header, _file.data(), sizeof(header));
+        if (!isEventLogHeader(header)) {
+            _file.close();
+            return false;
+        }
+        // A recording cut short may end in part of a record; leave it out.
+        _records = _file.data() + sizeof(EventLogHeader);
+        _count = (_file.size() - sizeof(EventLogHeader)) / sizeof(EventRecord);
+        return true;
+    }
+
+    // Number of events in the log.
+    size_t count() const { return _count; }
+
+    // The recorded event \a index, delivered as coming from myoFor(its device).
+    SensorEvent event(size_t index) const
+    {
+        EventRecord record;
+        memcpy(&record, _records + index * sizeof(EventRecord), sizeof(record));
+        return fromEventRecord(record, myoFor(record.device));
+    }
+
+    // The pointer that stands in for recorded armband \a device.
+    myo::Myo* myoFor(size_t device) const
+    {
+        return reinterpret_cast<myo::Myo*>(const_cast<char*>(&_devices[device]));
+    }
+
+    // Deliver every event to \a listener. With \a speed 0 the events are delivered as fast as possible; otherwise
+    // they are spaced out like the recording, \a speed times faster, by sleeping until each one is due.
+    void run(myo::DeviceListener& listener, double speed = 1.0)
+    {
+        if (_count == 0) {
+            return;
+        }
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+        uint64_t first = event(0).timestamp;
+        for (size_t i = 0; i < _count; i++) {
+            SensorEvent next = event(i);
+            if (speed > 0 && next.timestamp > first) {
+                std::chrono::microseconds due(static_cast<int64_t>((next.timestamp - first) / speed));
+                std::this_thread::sleep_until(start + due);
+            }
+            dispatchSensorEvent(listener, next);
+        }
+    }
+
+private:
+    MappedFile _file;
+    const unsigned char* _records;
+    size_t _count;
+
+    // Only their addresses are used.
+    char _devices[maxDevices];
+
+    // Not implemented
+    EventReplay(const EventReplay&);
+    EventReplay& operator=(const EventReplay&);
+};
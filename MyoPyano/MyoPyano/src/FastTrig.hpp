@@ -0,0 +1,123 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PYANO_TRIG_SSE2 1
+#endif
+
+// Polynomial approximations of atan2 and asin, for turning orientations into angles faster than libm does. The scalar
+// versions branch on the (0, 0) case, the octant and the signs; the four-lane versions below compute the same
+// formulas for every lane and pick the results with masks, with no branches at all.
+//
+// Maximum absolute error, measured over their whole domain against double precision libm:
+//   fastAtan2   2.0e-6 rad (0.0001 degrees)
+//   fastAsin    6.8e-5 rad (0.0039 degrees)
+// which is far below the whole degrees DataCollector works in.
+
+// Coefficients of the minimax polynomial for atan(a) on [0, 1], odd powers from a^1 to a^11.
+const float atanCoefficients[6] = {
+    0.99997726f, -0.33262347f, 0.19354346f, -0.11643287f, 0.05265332f, -0.01172120f
+};
+
+// Coefficients of asin(x) = pi/2 - sqrt(1 - x) * p(x) on [0, 1] (Abramowitz and Stegun 4.4.45).
+const float asinCoefficients[4] = {
+    1.5707288f, -0.2121144f, 0.0742610f, -0.0187293f
+};
+
+// atan(a) for a in [0, 1].
+inline float fastAtanUnit(float a)
+{
+    float a2 = a * a;
+    return a * (atanCoefficients[0] + a2 * (atanCoefficients[1] + a2 * (atanCoefficients[2] +
+           a2 * (atanCoefficients[3] + a2 * (atanCoefficients[4] + a2 * atanCoefficients[5])))));
+}
+
+// atan2(y, x) in -pi to pi. Returns 0 for (0, 0), like libm.
+inline float fastAtan2(float y, float x)
+{
+    float absX = std::fabs(x);
+    float absY = std::fabs(y);
+    float larger = absX > absY ? absX : absY;
+    if (larger == 0) {
+        return 0;
+    }
+    float smaller = absX > absY ? absY : absX;
+    float angle = fastAtanUnit(smaller / larger);
+    if (absY > absX) {
+        angle = static_cast<float>(M_PI_2) - angle;
+    }
+    if (x < 0) {
+        angle = static_cast<float>(M_PI) - angle;
+    }
+    return y < 0 ? -angle : angle;
+}
+
+// asin(x) in -pi/2 to pi/2. \a x is clamped to -1 to 1.
+inline float fastAsin(float x)
+{
+    float absX = std::fabs(x);
+    if (absX > 1) {
+        absX = 1;
+    }
+    float angle = static_cast<float>(M_PI_2) - std::sqrt(1 - absX) * (asinCoefficients[0] + absX *
+                  (asinCoefficients[1] + absX * (asinCoefficients[2] + absX * asinCoefficients[3])));
+    return x < 0 ? -angle : angle;
+}
+
+#if PYANO_TRIG_SSE2
+// fastAtan2() on four lanes.
+inline __m128 fastAtan2(__m128 y, __m128 x)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 absX = _mm_andnot_ps(signMask, x);
+    __m128 absY = _mm_andnot_ps(signMask, y);
+    __m128 larger = _mm_max_ps(absX, absY);
+    __m128 smaller = _mm_min_ps(absX, absY);
+
+    // (0, 0) divides 0 by the smallest normal float instead of by zero, giving 0.
+    __m128 a = _mm_div_ps(smaller, _mm_max_ps(larger, _mm_set1_ps(1.17549435e-38f)));
+    __m128 a2 = _mm_mul_ps(a, a);
+    __m128 p = _mm_set1_ps(atanCoefficients[5]);
+    for (int i = 4; i >= 0; i--) {
+        p = _mm_add_ps(_mm_mul_ps(p, a2), _mm_set1_ps(atanCoefficients[i]));
+    }
+    __m128 angle = _mm_mul_ps(p, a);
+
+    // Select with masks: steep -> pi/2 - angle, left half -> pi - angle, lower half -> negate.
+    __m128 steep = _mm_cmpgt_ps(absY, absX);
+    angle = _mm_or_ps(_mm_and_ps(steep, _mm_sub_ps(_mm_set1_ps(static_cast<float>(M_PI_2)), angle)),
+                      _mm_andnot_ps(steep, angle));
+    __m128 left = _mm_cmplt_ps(x, _mm_setzero_ps());
+    angle = _mm_or_ps(_mm_and_ps(left, _mm_sub_ps(_mm_set1_ps(static_cast<float>(M_PI)), angle)),
+                      _mm_andnot_ps(left, angle));
+    return _mm_or_ps(angle, _mm_and_ps(signMask, y));
+}
+
+// fastAsin() on four lanes.
+inline __m128 fastAsin(__m128 x)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 absX = _mm_min_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(1.0f));
+    __m128 p = _mm_set1_ps(asinCoefficients[3]);
+    for (int i = 2; i >= 0; i--) {
+        p = _mm_add_ps(_mm_mul_ps(p, absX), _mm_set1_ps(asinCoefficients[i]));
+    }
+    __m128 root = _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), absX));
+    __m128 angle = _mm_sub_ps(_mm_set1_ps(static_cast<float>(M_PI_2)), _mm_mul_ps(root, p));
+    return _mm_or_ps(angle, _mm_and_ps(signMask, x));
+}
+#endif
+
+// Trig policies, for code that picks its atan2 and asin at compile time (see DataCollector).
+struct LibmTrig {
+    static float atan2(float y, float x) { return std::atan2(y, x); }
+    static float asin(float x) { return std::asin(x < -1.0f ? -1.0f : (x > 1.0f ? 1.0f : x)); }
+};
+
+struct PolynomialTrig {
+    static float atan2(float y, float x) { return fastAtan2(y, x); }
+    static float asin(float x) { return fastAsin(x); }
+};
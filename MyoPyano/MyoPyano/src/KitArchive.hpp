@@ -0,0 +1,266 @@
+#pragma once
+
+#include <atomic>
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "../include/irrKlang/irrKlang.h"
+#include "MappedFile.hpp"
+#include "SampleBank.hpp"
+
+// A kit archive packs all the samples of a drum kit into one file, so a kit is opened and mapped once instead of
+// file by file. Layout, all integers little-endian:
+//
+//   KitArchiveHeader                     magic "MPKT", version, entry count
+//   KitArchiveEntry[entryCount]          name, offset and size of each sample
+//   sample data                          each blob starts on a kitArchiveAlignment boundary
+//
+// Entry names are the names the application asks for, e.g. "Sounds/hh4.wav".
+const uint32_t kitArchiveVersion = 1;
+const size_t kitArchiveAlignment = 64;
+
+struct KitArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct KitArchiveEntry {
+    char name[48];
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Pack every file in \a directory into a kit archive at \a archiveName. Returns false on any I/O error or if a
+// name doesn't fit in an entry.
+inline bool writeKitArchive(const std::string& directory, const std::string& archiveName)
+{
+    std::vector<std::string> names = listDirectory(directory);
+
+    std::vector<KitArchiveEntry> entries(names.size());
+    std::vector<std::vector<unsigned char> > blobs(names.size());
+    uint64_t offset = sizeof(KitArchiveHeader) + names.size() * sizeof(KitArchiveEntry);
+    for (size_t i = 0; i < names.size(); i++) {
+        std::string name = directory + "/" + names[i];
+        if (name.size() >= sizeof(entries[i].name)) {
+            return false;
+        }
+
+        MappedFile file;
+        if (!file.open(name)) {
+            return false;
+        }
+        blobs[i].assign(file.data(), file.data() + file.size());
+
+        memset(&entries[i], 0, sizeof(entries[i]));
+        memcpy(entries[i].name, name.c_str(), name.size());
+        offset = (offset + kitArchiveAlignment - 1) & ~static_cast<uint64_t>(kitArchiveAlignment - 1);
+        entries[i].offset = offset;
+        entries[i].size = blobs[i].size();
+        offset += blobs[i].size();
+    }
+
+    FILE* out = fopen(archiveName.c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+
+    KitArchiveHeader header;
+    memcpy(header.magic, "MPKT", 4);
+    header.version = kitArchiveVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.reserved = 0;
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    if (ok && !entries.empty()) {
+        ok = fwrite(&entries[0], sizeof(KitArchiveEntry), entries.size(), out) == entries.size();
+    }
+    uint64_t written = sizeof(KitArchiveHeader) + entries.size() * sizeof(KitArchiveEntry);
+    static const unsigned char padding[kitArchiveAlignment] = { 0 };
+    for (size_t i = 0; ok && i < entries.size(); i++) {
+        ok = fwrite(padding, 1, static_cast<size_t>(entries[i].offset - written), out) == entries[i].offset - written;
+        ok = ok && (blobs[i].empty() || fwrite(&blobs[i][0], 1, blobs[i].size(), out) == blobs[i].size());
+        written = entries[i].offset + entries[i].size;
+    }
+
+    return fclose(out) == 0 && ok;
+}
+
+// A kit archive opened read-only through a memory mapping. Sample data is handed out as pointers into the mapping,
+// which SampleBank and KitFileReader keep, so an archive is opened at most once and stays mapped until it is destroyed.
+class KitArchive {
+public:
+    KitArchive()
+    : _entries(0)
+    , _entryCount(0)
+    {
+    }
+
+    // Map and validate \a archiveName. Returns false if it can't be opened or is not a well-formed kit archive, or
+    // if this archive is already open; a failed open may be retried.
+    bool open(const std::string& archiveName)
+    {
+        if (_file.isOpen()) {
+            return false;
+        }
+        if (!_file.open(archiveName) || !validate()) {
+            _file.close();
+            return false;
+        }
+        _name = archiveName;
+        return true;
+    }
+
+    // Return the index of the entry called \a name, ignoring case and treating '\' like '/', or -1.
+    int find(const char* name) const
+    {
+        for (size_t i = 0; i < _entryCount; i++) {
+            if (sameEntryName(_entries[i].name, name)) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    size_t size() const { return _entryCount; }
+
+    const char* entryName(size_t index) const { return _entries[index].name; }
+
+    const unsigned char* entryData(size_t index) const { return _file.data() + _entries[index].offset; }
+
+    size_t entrySize(size_t index) const { return static_cast<size_t>(_entries[index].size); }
+
+    const std::string& name() const { return _name; }
+
+private:
+    // Check the header and every entry of the mapped file, and take the entries from it if they are well formed.
+    bool validate()
+    {
+        if (_file.size() < sizeof(KitArchiveHeader)) {
+            return false;
+        }
+
+        const KitArchiveHeader* header = reinterpret_cast<const KitArchiveHeader*>(_file.data());
+        if (memcmp(header->magic, "MPKT", 4) != 0 || header->version != kitArchiveVersion) {
+            return false;
+        }
+        uint64_t indexEnd = sizeof(KitArchiveHeader) + uint64_t(header->entryCount) * sizeof(KitArchiveEntry);
+        if (indexEnd > _file.size()) {
+            return false;
+        }
+
+        const KitArchiveEntry* entries = reinterpret_cast<const KitArchiveEntry*>(header + 1);
+        for (uint32_t i = 0; i < header->entryCount; i++) {
+            if (entries[i].name[sizeof(entries[i].name) - 1] != 0 || entries[i].offset < indexEnd ||
+                entries[i].offset % kitArchiveAlignment != 0 || entries[i].offset > _file.size() ||
+                entries[i].size > _file.size() - entries[i].offset) {
+                return false;
+            }
+        }
+
+        _entries = entries;
+        _entryCount = header->entryCount;
+        return true;
+    }
+
+    static bool sameEntryName(const char* a, const char* b)
+    {
+        for (;; a++, b++) {
+            char ca = *a == '\\' ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(*a)));
+            char cb = *b == '\\' ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(*b)));
+            if (ca != cb) {
+                return false;
+            }
+            if (!ca) {
+                return true;
+            }
+        }
+    }
+
+    MappedFile _file;
+    std::string _name;
+    const KitArchiveEntry* _entries;
+    size_t _entryCount;
+};
+
+// An irrKlang file reader over one entry of a mapped kit archive.
+class KitFileReader : public irrklang::IFileReader {
+public:
+    KitFileReader(const char* name, const unsigned char* data, size_t size)
+    : _name(name)
+    , _data(data)
+    , _size(static_cast<irrklang::ik_s32>(size))
+    , _pos(0)
+    {
+    }
+
+    irrklang::ik_s32 read(void* buffer, irrklang::ik_u32 sizeToRead)
+    {
+        irrklang::ik_s32 count = _size - _pos;
+        if (static_cast<irrklang::ik_u32>(count) > sizeToRead) {
+            count = static_cast<irrklang::ik_s32>(sizeToRead);
+        }
+        memcpy(buffer, _data + _pos, count);
+        _pos += count;
+        return count;
+    }
+
+    bool seek(irrklang::ik_s32 finalPos, bool relativeMovement)
+    {
+        irrklang::ik_s32 pos = relativeMovement ? _pos + finalPos : finalPos;
+        if (pos < 0 || pos > _size) {
+            return false;
+        }
+        _pos = pos;
+        return true;
+    }
+
+    irrklang::ik_s32 getSize() { return _size; }
+
+    irrklang::ik_s32 getPos() { return _pos; }
+
+    const irrklang::ik_c8* getFileName() { return _name.c_str(); }
+
+private:
+    std::string _name;
+    const unsigned char* _data;
+    irrklang::ik_s32 _size;
+    irrklang::ik_s32 _pos;
+};
+
+// Serves irrKlang's file reads from the current kit archive. Names that aren't in the archive return 0, which makes
+// irrKlang fall back to the file system. Switching kits is a pointer swap; the archives themselves are owned by the
+// caller and must stay open while any sound loaded from them may still be read. setArchive() may be called from any
+// thread while irrKlang's thread is reading.
+class KitFileFactory : public irrklang::IFileFactory {
+public:
+    KitFileFactory(const KitArchive* archive = 0)
+    : _archive(archive)
+    {
+    }
+
+    void setArchive(const KitArchive* archive) { _archive.store(archive, std::memory_order_release); }
+
+    const KitArchive* archive() const { return _archive.load(std::memory_order_acquire); }
+
+    irrklang::IFileReader* createFileReader(const irrklang::ik_c8* filename)
+    {
+        const KitArchive* archive = _archive.load(std::memory_order_acquire);
+        if (!archive) {
+            return 0;
+        }
+        int index = archive->find(filename);
+        if (index < 0) {
+            return 0;
+        }
+        return new KitFileReader(filename, archive->entryData(index), archive->entrySize(index));
+    }
+
+private:
+    std::atomic<const KitArchive*> _archive;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The stages a sensor event goes through on its way to a drum sound, in order. DataCollector marks each one on its
+// Probe as the event passes it; the mixer stages come after, on the audio thread.
+enum LatencyStage {
+    stageDecoded,      // The Hub has decoded the event and handed it to the collector.
+    stageOriented,     // Angles, fusion and drift tracking are up to date with it.
+    stageStruck,       // It has been found to be a strike.
+    stageZoned,        // The zone, and so the pad, of the strike is known.
+    stageTriggered,    // The pad has been queued on the mixer, or started on irrKlang.
+    collectorStageCount
+};
+
+// The probe DataCollector uses unless told otherwise. It does nothing, and compiles to nothing.
+struct NoLatencyProbe {
+    // An event from armband \a myoIndex with sensor timestamp \a timestamp has reached stageDecoded.
+    void event(size_t myoIndex, uint64_t timestamp) {}
+
+    // The current event has reached \a stage.
+    void mark(LatencyStage stage) {}
+};
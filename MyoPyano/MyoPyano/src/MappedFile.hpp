@@ -0,0 +1,205 @@
+#pragma once
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A read-only memory mapping of a whole file. The contents are paged in by the OS on first access and shared with
+// the file cache, so nothing is read or copied up front. The mapping is released when the MappedFile is destroyed.
+class MappedFile {
+public:
+    MappedFile()
+    : _data(0)
+    , _size(0)
+#ifdef _WIN32
+    , _file(INVALID_HANDLE_VALUE)
+    , _mapping(0)
+#endif
+    {
+    }
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+    // Map \a fileName. Returns false if it can't be opened or is empty.
+    bool open(const std::string& fileName)
+    {
+        close();
+#ifdef _WIN32
+        _file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, 0);
+        if (_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(_file, &size) || size.QuadPart == 0) {
+            close();
+            return false;
+        }
+        _mapping = CreateFileMappingA(_file, 0, PAGE_READONLY, 0, 0, 0);
+        if (!_mapping) {
+            close();
+            return false;
+        }
+        _data = static_cast<const unsigned char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!_data) {
+            close();
+            return false;
+        }
+        _size = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* data = mmap(0, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        // The mapping keeps the file alive on its own.
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        _data = static_cast<const unsigned char*>(data);
+        _size = static_cast<size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        if (_data) {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping) {
+            CloseHandle(_mapping);
+        }
+        if (_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(_file);
+        }
+        _mapping = 0;
+        _file = INVALID_HANDLE_VALUE;
+#else
+        if (_data) {
+            munmap(const_cast<unsigned char*>(_data), _size);
+        }
+#endif
+        _data = 0;
+        _size = 0;
+    }
+
+    // Fault in every page of \a size bytes starting at \a data so that the first real access doesn't stall on a page
+    // fault. The OS is asked to read the whole range ahead, then every page is read through a volatile pointer, which
+    // the compiler has to keep even though nothing uses the bytes. Returns whether every page was resident afterwards,
+    // as reported by the OS rather than assumed; a page may still be evicted later under memory pressure.
+    static bool prefault(const void* data, size_t size)
+    {
+        if (size == 0) {
+            return true;
+        }
+        size_t page = pageSize();
+        const unsigned char* begin = static_cast<const unsigned char*>(data);
+        const unsigned char* first = begin - reinterpret_cast<size_t>(begin) % page;
+        size_t length = static_cast<size_t>(begin + size - first);
+#ifdef _WIN32
+#if _WIN32_WINNT >= 0x0602
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = const_cast<unsigned char*>(first);
+        range.NumberOfBytes = length;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+#else
+        madvise(const_cast<unsigned char*>(first), length, MADV_WILLNEED);
+#endif
+        const volatile unsigned char* bytes = first;
+        for (size_t offset = 0; offset < length; offset += page) {
+            bytes[offset];
+        }
+        return isResident(first, length);
+    }
+
+    bool isOpen() const { return _data != 0; }
+
+    const unsigned char* data() const { return _data; }
+
+    size_t size() const { return _size; }
+
+private:
+    static size_t pageSize()
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    // Whether every page of the page-aligned range of \a length bytes at \a first is in memory.
+    static bool isResident(const unsigned char* first, size_t length)
+    {
+        size_t page = pageSize();
+        size_t pages = (length + page - 1) / page;
+#ifdef _WIN32
+        std::vector<PSAPI_WORKING_SET_EX_INFORMATION> info(pages);
+        for (size_t i = 0; i < pages; i++) {
+            info[i].VirtualAddress = const_cast<unsigned char*>(first + i * page);
+        }
+        if (!QueryWorkingSetEx(GetCurrentProcess(), &info[0],
+                               static_cast<DWORD>(pages * sizeof(PSAPI_WORKING_SET_EX_INFORMATION)))) {
+            return false;
+        }
+        for (size_t i = 0; i < pages; i++) {
+            if (!info[i].VirtualAttributes.Valid) {
+                return false;
+            }
+        }
+#else
+#ifdef __APPLE__
+        std::vector<char> residency(pages);
+#else
+        std::vector<unsigned char> residency(pages);
+#endif
+        if (mincore(const_cast<unsigned char*>(first), length, &residency[0]) != 0) {
+            return false;
+        }
+        for (size_t i = 0; i < pages; i++) {
+            if (!(residency[i] & 1)) {
+                return false;
+            }
+        }
+#endif
+        return true;
+    }
+
+    const unsigned char* _data;
+    size_t _size;
+#ifdef _WIN32
+    HANDLE _file;
+    HANDLE _mapping;
+#endif
+
+    // Not implemented
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
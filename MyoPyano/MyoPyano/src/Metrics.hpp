@@ -0,0 +1,295 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Metrics are kept by the thread they describe and read by another, usually a MetricsReporter. Every Counter and
+// Histogram has exactly one writer, so an update is a relaxed load and store, with no locked instruction and no
+// contention: a handful of nanoseconds. Readers may see an update a little late, never a torn one.
+
+// A timestamp for measuring short durations: the CPU's time stamp counter where there is one, else nanoseconds on
+// the steady clock. See metricTicksPerSecond().
+inline uint64_t metricTicks()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// The rate metricTicks() counts at, measured against the steady clock the first time it is asked for, which takes
+// 20 ms.
+inline double metricTicksPerSecond()
+{
+    static const double rate = [] {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+        uint64_t startTicks = metricTicks();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        uint64_t ticks = metricTicks() - startTicks;
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        return ticks / elapsed.count();
+    }();
+    return rate;
+}
+
+// Index of the highest set bit of \a value, which must not be 0.
+inline unsigned highestBit(uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return index;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32))) {
+        return index + 32;
+    }
+    _BitScanReverse(&index, static_cast<unsigned long>(value));
+    return index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+// A count with a single writer.
+class Counter {
+public:
+    Counter()
+    : _value(0)
+    {
+    }
+
+    void add(uint64_t n = 1)
+    {
+        _value.store(_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> _value;
+
+    // Not implemented
+    Counter(const Counter&);
+    Counter& operator=(const Counter&);
+};
+
+// The counts of a Histogram at one moment, and what can be worked out from them.
+class HistogramSnapshot {
+public:
+    std::vector<uint64_t> counts;
+
+    uint64_t total() const
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            sum += counts[i];
+        }
+        return sum;
+    }
+
+    // The value below which a fraction \a q of the recorded values lie, to the histogram's precision. 0 if nothing
+    // was recorded.
+    uint64_t quantile(double q) const;
+
+    // The largest value recorded, to the histogram's precision.
+    uint64_t max() const;
+
+    // What was recorded between \a earlier and this snapshot.
+    HistogramSnapshot since(const HistogramSnapshot& earlier) const
+    {
+        HistogramSnapshot difference;
+        difference.counts.resize(counts.size());
+        for (size_t i = 0; i < counts.size(); i++) {
+            difference.counts[i] = counts[i] - (i < earlier.counts.size() ? earlier.counts[i] : 0);
+        }
+        return difference;
+    }
+};
+
+// A histogram of 64-bit values with a single writer, in the manner of HdrHistogram: values below 16 have a bucket
+// each, and every power of two above is split into 16 buckets, so any value is known to within 1/16th over the
+// whole range with under a thousand buckets. Recording is a bit scan and a counter update.
+class Histogram {
+public:
+    static const unsigned subBucketBits = 4;
+    static const size_t subBuckets = size_t(1) << subBucketBits;
+    static const size_t bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+    Histogram()
+    {
+        for (size_t i = 0; i < bucketCount; i++) {
+            _counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void record(uint64_t value)
+    {
+        std::atomic<uint64_t>& count = _counts[bucketOf(value)];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void snapshot(HistogramSnapshot& out) const
+    {
+        out.counts.resize(bucketCount);
+        for (size_t i = 0; i < bucketCount; i++) {
+            out.counts[i] = _counts[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    static size_t bucketOf(uint64_t value)
+    {
+        if (value < subBuckets) {
+            return static_cast<size_t>(value);
+        }
+        unsigned shift = highestBit(value) - subBucketBits;
+        return ((shift + 1) << subBucketBits) + static_cast<size_t>((value >> shift) - subBuckets);
+    }
+
+    // The smallest value counted in \a bucket.
+    static uint64_t lowestIn(size_t bucket)
+    {
+        if (bucket < subBuckets) {
+            return bucket;
+        }
+        unsigned shift = static_cast<unsigned>(bucket >> subBucketBits) - 1;
+        return static_cast<uint64_t>(subBuckets + (bucket & (subBuckets - 1))) << shift;
+    }
+
+private:
+    std::atomic<uint64_t> _counts[bucketCount];
+
+    // Not implemented
+    Histogram(const Histogram&);
+    Histogram& operator=(const Histogram&);
+};
+
+inline uint64_t HistogramSnapshot::quantile(double q) const
+{
+    uint64_t rank = static_cast<uint64_t>(q * total());
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen > rank) {
+            return Histogram::lowestIn(i);
+        }
+    }
+    return max();
+}
+
+inline uint64_t HistogramSnapshot::max() const
+{
+    for (size_t i = counts.size(); i > 0; i--) {
+        if (counts[i - 1]) {
+            return Histogram::lowestIn(i - 1);
+        }
+    }
+    return 0;
+}
+
+// Records the ticks from its construction to its destruction into a histogram, if it is given one.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram* histogram)
+    : _histogram(histogram)
+    , _start(histogram ? metricTicks() : 0)
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        if (_histogram) {
+            _histogram->record(metricTicks() - _start);
+        }
+    }
+
+private:
+    Histogram* _histogram;
+    uint64_t _start;
+
+    // Not implemented
+    ScopedTimer(const ScopedTimer&);
+    ScopedTimer& operator=(const ScopedTimer&);
+};
+
+// What the thread running DataCollector keeps track of.
+struct CollectorMetrics {
+    // Armbands past the last share it.
+    static const size_t maxArmbands = 16;
+
+    // Zone numbers from 1 to maxZones are counted by number, any others as zone 0, as are strikes with no zone.
+    static const size_t maxZones = 64;
+
+    // The armband streams orientation at 50 Hz.
+    static const uint64_t sampleInterval = 20000;
+
+    struct Armband {
+        Armband()
+        : lastTimestamp(0)
+        {
+        }
+
+        Counter events;
+        // Samples that never arrived, going by the gaps between timestamps.
+        Counter dropped;
+        // Samples that arrived no later than the one before them.
+        Counter late;
+        // Only touched by the writer.
+        uint64_t lastTimestamp;
+    };
+
+    // An orientation sample with sensor timestamp \a timestamp arrived from armband \a armband.
+    void sample(size_t armband, uint64_t timestamp)
+    {
+        Armband& a = armbands[armband < maxArmbands ? armband : maxArmbands - 1];
+        a.events.add();
+        if (a.lastTimestamp != 0) {
+            if (timestamp <= a.lastTimestamp) {
+                a.late.add();
+                return;
+            }
+            uint64_t missing = (timestamp - a.lastTimestamp + sampleInterval / 2) / sampleInterval;
+            if (missing > 1) {
+                a.dropped.add(missing - 1);
+            }
+        }
+        a.lastTimestamp = timestamp;
+    }
+
+    // A strike by \a arm (a DrumKit::Arm) landed in the zone numbered \a zone.
+    void strike(size_t arm, int zone)
+    {
+        strikes[arm][zone > 0 && static_cast<size_t>(zone) <= maxZones ? zone : 0].add();
+    }
+
+    Armband armbands[maxArmbands];
+    Counter strikes[2][maxZones + 1];
+
+    // Ticks (see metricTicks()) spent in each orientation and gyroscope callback.
+    Histogram callbacks;
+};
+
+// What the thread calling Mixer::mix() keeps track of.
+struct MixerMetrics {
+    Counter blocks;
+    Counter frames;
+
+    // Ticks (see metricTicks()) spent in each mix() call.
+    Histogram mixTime;
+
+    // Voices playing in each block.
+    Histogram voices;
+};
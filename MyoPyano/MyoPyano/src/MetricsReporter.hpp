@@ -0,0 +1,161 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <thread>
+
+#include "Metrics.hpp"
+
+// MetricsReporter snapshots a collector's and, optionally, a mixer's metrics on a thread of its own and prints what
+// happened since the last report, every interval. Only the reporter reads the metrics, and it takes no lock the
+// threads being measured could wait on.
+class MetricsReporter {
+public:
+    MetricsReporter(const CollectorMetrics& collector, const MixerMetrics* mixer, std::ostream& out)
+    : _collector(collector)
+    , _mixer(mixer)
+    , _out(out)
+    , _running(false)
+    {
+    }
+
+    ~MetricsReporter()
+    {
+        stop();
+    }
+
+    // Report every \a interval seconds until stop().
+    void start(double interval)
+    {
+        if (_running) {
+            return;
+        }
+        _running = true;
+        _thread = std::thread(&MetricsReporter::run, this, interval);
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_running) {
+                return;
+            }
+            _running = false;
+        }
+        _wake.notify_one();
+        _thread.join();
+    }
+
+private:
+    // Everything the reports are worked out from.
+    struct Snapshot {
+        uint64_t events[CollectorMetrics::maxArmbands];
+        uint64_t dropped[CollectorMetrics::maxArmbands];
+        uint64_t late[CollectorMetrics::maxArmbands];
+        uint64_t strikes[2][CollectorMetrics::maxZones + 1];
+        HistogramSnapshot callbacks;
+        uint64_t blocks;
+        HistogramSnapshot mixTime;
+        HistogramSnapshot voices;
+    };
+
+    void take(Snapshot& snapshot) const
+    {
+        for (size_t i = 0; i < CollectorMetrics::maxArmbands; i++) {
+            snapshot.events[i] = _collector.armbands[i].events.value();
+            snapshot.dropped[i] = _collector.armbands[i].dropped.value();
+            snapshot.late[i] = _collector.armbands[i].late.value();
+        }
+        for (size_t arm = 0; arm < 2; arm++) {
+            for (size_t zone = 0; zone <= CollectorMetrics::maxZones; zone++) {
+                snapshot.strikes[arm][zone] = _collector.strikes[arm][zone].value();
+            }
+        }
+        _collector.callbacks.snapshot(snapshot.callbacks);
+        snapshot.blocks = 0;
+        if (_mixer) {
+            snapshot.blocks = _mixer->blocks.value();
+            _mixer->mixTime.snapshot(snapshot.mixTime);
+            _mixer->voices.snapshot(snapshot.voices);
+        }
+    }
+
+    void run(double interval)
+    {
+        double ticksPerMicrosecond = metricTicksPerSecond() / 1e6;
+        Snapshot previous;
+        take(previous);
+        std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_running) {
+            _wake.wait_for(lock, std::chrono::duration<double>(interval));
+            Snapshot current;
+            take(current);
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            std::chrono::duration<double> elapsed = now - last;
+            report(previous, current, elapsed.count(), ticksPerMicrosecond);
+            previous = current;
+            last = now;
+        }
+    }
+
+    void report(const Snapshot& before, const Snapshot& after, double seconds, double ticksPerMicrosecond) const
+    {
+        // Built up first so the report isn't broken up by other threads' output.
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1) << "[metrics " << seconds << " s]";
+        for (size_t i = 0; i < CollectorMetrics::maxArmbands; i++) {
+            if (after.events[i] == 0) {
+                continue;
+            }
+            line << " armband " << i << ": " << (after.events[i] - before.events[i]) / seconds << " samples/s, "
+                 << after.dropped[i] - before.dropped[i] << " dropped, " << after.late[i] - before.late[i]
+                 << " late;";
+        }
+        line << "\n  strikes:";
+        static const char armNames[2] = { 'R', 'L' };
+        for (size_t arm = 0; arm < 2; arm++) {
+            for (size_t zone = 0; zone <= CollectorMetrics::maxZones; zone++) {
+                uint64_t count = after.strikes[arm][zone] - before.strikes[arm][zone];
+                if (count) {
+                    line << ' ' << armNames[arm] << zone << '=' << count;
+                }
+            }
+        }
+        line << "\n  callback us:";
+        printLatencies(line, after.callbacks.since(before.callbacks), ticksPerMicrosecond);
+        if (_mixer) {
+            HistogramSnapshot voices = after.voices.since(before.voices);
+            line << "\n  mix us:";
+            printLatencies(line, after.mixTime.since(before.mixTime), ticksPerMicrosecond);
+            line << " in " << after.blocks - before.blocks << " blocks; voices p50 " << voices.quantile(0.5)
+                 << " max " << voices.max();
+        }
+        line << "\n";
+        _out << line.str() << std::flush;
+    }
+
+    static void printLatencies(std::ostream& out, const HistogramSnapshot& ticks, double ticksPerMicrosecond)
+    {
+        out << std::setprecision(2) << " p50 " << ticks.quantile(0.5) / ticksPerMicrosecond
+            << " p99 " << ticks.quantile(0.99) / ticksPerMicrosecond
+            << " max " << ticks.max() / ticksPerMicrosecond << std::setprecision(1);
+    }
+
+    const CollectorMetrics& _collector;
+    const MixerMetrics* _mixer;
+    std::ostream& _out;
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _running;
+
+    // Not implemented
+    MetricsReporter(const MetricsReporter&);
+    MetricsReporter& operator=(const MetricsReporter&);
+};
@@ -0,0 +1,350 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <atomic>
+#include <cmath>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PYANO_MIX_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PYANO_MIX_SSE2 1
+#endif
+
+#include "../include/irrKlang/irrKlang.h"
+#include "Metrics.hpp"
+#include "Polyphony.hpp"
+#include "SpscRing.hpp"
+
+// Index of a sample loaded into a Mixer.
+typedef int MixerSampleId;
+
+// Add \a frames frames of interleaved stereo \a src, scaled by \a gainLeft and \a gainRight, into interleaved stereo
+// \a out. This and mixMonoInto() are the inner loops of the mixer; they use AVX or SSE2 when the compiler targets
+// them and plain C++ otherwise.
+inline void mixStereoInto(float* out, const float* src, size_t frames, float gainLeft, float gainRight)
+{
+    size_t count = frames * 2;
+    size_t i = 0;
+#if PYANO_MIX_AVX
+    __m256 gain8 = _mm256_setr_ps(gainLeft, gainRight, gainLeft, gainRight, gainLeft, gainRight, gainLeft, gainRight);
+    for (; i + 8 <= count; i += 8) {
+        __m256 o = _mm256_loadu_ps(out + i);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(o, _mm256_mul_ps(_mm256_loadu_ps(src + i), gain8)));
+    }
+#endif
+#if PYANO_MIX_SSE2
+    __m128 gain4 = _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+    for (; i + 4 <= count; i += 4) {
+        __m128 o = _mm_loadu_ps(out + i);
+        _mm_storeu_ps(out + i, _mm_add_ps(o, _mm_mul_ps(_mm_loadu_ps(src + i), gain4)));
+    }
+#endif
+    for (; i < count; i += 2) {
+        out[i] += src[i] * gainLeft;
+        out[i + 1] += src[i + 1] * gainRight;
+    }
+}
+
+// Add \a frames frames of mono \a src into interleaved stereo \a out, panned by \a gainLeft and \a gainRight.
+inline void mixMonoInto(float* out, const float* src, size_t frames, float gainLeft, float gainRight)
+{
+    size_t i = 0;
+#if PYANO_MIX_SSE2
+    __m128 gain4 = _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+    for (; i + 4 <= frames; i += 4) {
+        __m128 s = _mm_loadu_ps(src + i);
+        // Duplicate each mono sample into a left/right pair.
+        __m128 low = _mm_unpacklo_ps(s, s);
+        __m128 high = _mm_unpackhi_ps(s, s);
+        float* o = out + i * 2;
+        _mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_mul_ps(low, gain4)));
+        _mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_mul_ps(high, gain4)));
+    }
+#endif
+    for (; i < frames; i++) {
+        out[i * 2] += src[i] * gainLeft;
+        out[i * 2 + 1] += src[i] * gainRight;
+    }
+}
+
+// Convert \a count float samples in -1..1 to 16 bit, saturating anything outside that range.
+inline void floatToS16(const float* in, int16_t* out, size_t count)
+{
+    size_t i = 0;
+#if PYANO_MIX_SSE2
+    __m128 scale = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i), scale));
+        __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+    }
+#endif
+    for (; i < count; i++) {
+        float v = in[i] * 32767.0f;
+        out[i] = static_cast<int16_t>(v > 32767.0f ? 32767 : (v < -32768.0f ? -32768 : static_cast<int>(std::floor(v + 0.5f))));
+    }
+}
+
+// Mixer is an in-process software mixer with a fixed pool of voices. Samples are converted once, when loaded, to
+// float at the mixer's sample rate, so mixing a voice is a single multiply-add pass over its data. The caller
+// decides how many frames each mix() call produces, which sets the block size and so the output latency. When all
+// voices are busy, or a pad is at its limit, a voice is stolen as allocateVoice() describes.
+//
+// addSample() and trigger() are called from the thread detecting strikes, mix() from the audio thread. Triggers
+// are handed over through a lock-free queue and only the audio thread touches the voices. Samples are never moved
+// once added, so a kit can be loaded while the mixer is running. Nothing allocates after construction except
+// addSample().
+class Mixer {
+public:
+    static const MixerSampleId invalidSample = -1;
+    static const size_t voiceCount = 32;
+
+    Mixer(int sampleRate = 44100, size_t maxBlockFrames = 1024, VoiceStealing stealing = stealOldest)
+    : _sampleRate(sampleRate)
+    , _maxBlockFrames(maxBlockFrames)
+    , _stealing(stealing)
+    , _started(0)
+    , _framesMixed(0)
+    , _voicesLeft(0)
+    , _metrics(0)
+    {
+        memset(_voices, 0, sizeof(_voices));
+        memset(_voiceInfo, 0, sizeof(_voiceInfo));
+    }
+
+    int sampleRate() const { return _sampleRate; }
+
+    size_t maxBlockFrames() const { return _maxBlockFrames; }
+
+    // Convert and add decoded PCM data in \a format, resampling it to the mixer's rate if necessary.
+    MixerSampleId addSample(const void* pcm, const irrklang::SAudioStreamFormat& format)
+    {
+        if (!pcm || format.FrameCount <= 0 || (format.ChannelCount != 1 && format.ChannelCount != 2)) {
+            return invalidSample;
+        }
+
+        size_t channels = static_cast<size_t>(format.ChannelCount);
+        size_t inFrames = static_cast<size_t>(format.FrameCount);
+        std::vector<float> converted(inFrames * channels);
+        for (size_t i = 0; i < converted.size(); i++) {
+            if (format.SampleFormat == irrklang::ESF_U8) {
+                converted[i] = (static_cast<const uint8_t*>(pcm)[i] - 128) / 128.0f;
+            } else {
+                converted[i] = static_cast<const int16_t*>(pcm)[i] / 32768.0f;
+            }
+        }
+
+        MixerSample sample;
+        sample.channels = channels;
+        if (format.SampleRate == _sampleRate) {
+            sample.data.swap(converted);
+        } else {
+            // Linear interpolation is plenty for drum one-shots, and it is done once, here.
+            double step = static_cast<double>(format.SampleRate) / _sampleRate;
+            size_t outFrames = static_cast<size_t>(inFrames / step);
+            sample.data.resize(outFrames * channels);
+            for (size_t frame = 0; frame < outFrames; frame++) {
+                double at = frame * step;
+                size_t index = static_cast<size_t>(at);
+                size_t next = index + 1 < inFrames ? index + 1 : index;
+                float t = static_cast<float>(at - index);
+                for (size_t c = 0; c < channels; c++) {
+                    sample.data[frame * channels + c] = converted[index * channels + c] * (1 - t) +
+                                                        converted[next * channels + c] * t;
+                }
+            }
+        }
+        sample.frames = sample.data.size() / channels;
+
+        _samples.push_back(sample);
+        return static_cast<MixerSampleId>(_samples.size() - 1);
+    }
+
+    // Add the decoded data of an irrKlang sound source. Only works for sources that aren't streamed.
+    MixerSampleId addSample(irrklang::ISoundSource* source)
+    {
+        return source ? addSample(source->getSampleData(), source->getAudioFormat()) : invalidSample;
+    }
+
+    // Start playing \a sample at \a gain (0 to 1) and \a pan (-1 left to 1 right), as a hit of \a pad subject to
+    // \a limits. The sample starts at output frame \a atFrame (see framesMixed()), or at the start of the next block
+    // if that has already been mixed, which with the default of 0 is always. Returns false if too many triggers are
+    // already waiting.
+    bool trigger(MixerSampleId sample, float gain, float pan, int pad = -1, const VoiceLimits& limits = VoiceLimits(),
+                 uint64_t atFrame = 0)
+    {
+        if (sample < 0 || static_cast<size_t>(sample) >= _samples.size()) {
+            return false;
+        }
+        Trigger command = { &_samples[sample], gain, pan, pad, limits, atFrame };
+        if (!_triggers.tryPush(command)) {
+            _triggersDropped.add();
+            return false;
+        }
+        return true;
+    }
+
+    // Number of triggers refused because too many were already waiting. Can be read from any thread.
+    uint64_t triggersDropped() const { return _triggersDropped.value(); }
+
+    // Keep count of blocks, voices and time spent mixing in \a metrics, or stop if it is 0. Must be called from the
+    // thread calling mix(), or before it starts.
+    void useMetrics(MixerMetrics* metrics) { _metrics = metrics; }
+
+    // The output clock: the number of frames mixed so far. Can be read from any thread.
+    uint64_t framesMixed() const { return _framesMixed.load(std::memory_order_acquire); }
+
+    // Mix the next \a frames frames (at most maxBlockFrames()) of interleaved stereo float output into \a out.
+    void mix(float* out, size_t frames)
+    {
+        ScopedTimer timer(_metrics ? &_metrics->mixTime : 0);
+        uint64_t blockStart = _framesMixed.load(std::memory_order_relaxed);
+        if (_triggers.size() != 0) {
+            // Taking a trigger off the queue must not make the mixer look idle before its voice is counted.
+            _voicesLeft.store(voiceCount, std::memory_order_release);
+        }
+        Trigger command;
+        while (_triggers.tryPop(command)) {
+            startVoice(command, blockStart);
+        }
+
+        memset(out, 0, frames * 2 * sizeof(float));
+        size_t playing = 0;
+        size_t left = 0;
+        for (size_t v = 0; v < voiceCount; v++) {
+            Voice& voice = _voices[v];
+            if (!voice.sample) {
+                continue;
+            }
+            playing++;
+
+            // A voice scheduled for a later frame stays silent until then.
+            if (voice.delay >= frames) {
+                voice.delay -= frames;
+                left++;
+                continue;
+            }
+            size_t offset = voice.delay;
+            voice.delay = 0;
+
+            size_t remaining = voice.sample->frames - voice.position;
+            size_t count = remaining < frames - offset ? remaining : frames - offset;
+            const float* src = &voice.sample->data[voice.position * voice.sample->channels];
+            if (voice.sample->channels == 2) {
+                mixStereoInto(out + offset * 2, src, count, voice.gainLeft, voice.gainRight);
+            } else {
+                mixMonoInto(out + offset * 2, src, count, voice.gainLeft, voice.gainRight);
+            }
+
+            voice.position += count;
+            if (voice.position >= voice.sample->frames) {
+                voice.sample = 0;
+            } else {
+                left++;
+            }
+        }
+        _voicesLeft.store(left, std::memory_order_release);
+        _framesMixed.store(blockStart + frames, std::memory_order_release);
+        if (_metrics) {
+            _metrics->blocks.add();
+            _metrics->frames.add(frames);
+            _metrics->voices.record(playing);
+        }
+    }
+
+    // Number of voices started since the mixer was made, one per trigger. Only meaningful on the thread calling
+    // mix().
+    uint64_t voicesStarted() const { return _started; }
+
+    // Whether every trigger so far has been mixed to the end of its sample, so further blocks would be silent. Can be
+    // read from any thread.
+    bool idle() const
+    {
+        return _triggers.size() == 0 && _voicesLeft.load(std::memory_order_acquire) == 0;
+    }
+
+    // Number of voices currently playing. Only meaningful on the thread calling mix().
+    size_t activeVoices() const
+    {
+        size_t count = 0;
+        for (size_t v = 0; v < voiceCount; v++) {
+            if (_voices[v].sample) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+private:
+    struct MixerSample {
+        std::vector<float> data;
+        size_t channels;
+        size_t frames;
+    };
+
+    struct Voice {
+        const MixerSample* sample;
+        size_t position;
+        size_t delay;
+        float gainLeft;
+        float gainRight;
+    };
+
+    struct Trigger {
+        const MixerSample* sample;
+        float gain;
+        float pan;
+        int pad;
+        VoiceLimits limits;
+        uint64_t atFrame;
+    };
+
+    // Start a voice for \a command in the block starting at output frame \a blockStart.
+    void startVoice(const Trigger& command, uint64_t blockStart)
+    {
+        // A stopped voice is simply cut off at the next block.
+        size_t v = allocateVoice(_voiceInfo, voiceCount, command.pad, command.limits, _stealing,
+                                 [this](size_t i) { return _voices[i].sample != 0; },
+                                 [this](size_t i) { _voices[i].sample = 0; });
+        Voice* voice = &_voices[v];
+        VoiceInfo info = { command.pad, command.limits.chokeGroup, command.gain, _started++ };
+        _voiceInfo[v] = info;
+
+        // Equal-power pan law, so a pad sounds equally loud anywhere in the stereo field.
+        float angle = (command.pan + 1.0f) * static_cast<float>(M_PI) / 4.0f;
+        voice->sample = command.sample;
+        voice->position = 0;
+        voice->delay = command.atFrame > blockStart ? static_cast<size_t>(command.atFrame - blockStart) : 0;
+        voice->gainLeft = command.gain * std::cos(angle);
+        voice->gainRight = command.gain * std::sin(angle);
+    }
+
+    int _sampleRate;
+    size_t _maxBlockFrames;
+    VoiceStealing _stealing;
+    uint64_t _started;
+    std::atomic<uint64_t> _framesMixed;
+
+    // Voices still playing after the last block, for idle().
+    std::atomic<size_t> _voicesLeft;
+    MixerMetrics* _metrics;
+
+    // Only written by the thread calling trigger().
+    Counter _triggersDropped;
+    std::deque<MixerSample> _samples;
+    Voice _voices[voiceCount];
+    VoiceInfo _voiceInfo[voiceCount];
+    SpscRing<Trigger, 256> _triggers;
+
+    // Not implemented
+    Mixer(const Mixer&);
+    Mixer& operator=(const Mixer&);
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string.h>
+#include <vector>
+
+#include "../include/irrKlang/irrKlang.h"
+#include "KitArchive.hpp"
+#include "Mixer.hpp"
+
+// The name to play2D() to hear a Mixer through irrKlang. The extension is what MixerStreamLoader answers to.
+const char* const mixerStreamName = "pyano.mixerstream";
+
+// An endless irrKlang audio stream that pulls its audio out of a Mixer, one block at a time. irrKlang still owns the
+// device and its buffering, but everything upstream of it (voices, gain, pan, block size) is ours.
+class MixerStream : public irrklang::IAudioStream {
+public:
+    MixerStream(Mixer& mixer, size_t blockFrames)
+    : _mixer(mixer)
+    , _blockFrames(blockFrames < mixer.maxBlockFrames() ? blockFrames : mixer.maxBlockFrames())
+    , _block(_blockFrames * 2)
+    , _blockPos(_blockFrames)
+    {
+    }
+
+    irrklang::SAudioStreamFormat getFormat()
+    {
+        irrklang::SAudioStreamFormat format;
+        format.ChannelCount = 2;
+        format.FrameCount = -1;
+        format.SampleRate = _mixer.sampleRate();
+        format.SampleFormat = irrklang::ESF_S16;
+        return format;
+    }
+
+    bool setPosition(irrklang::ik_s32 pos) { return true; }
+
+    bool getIsSeekingSupported() { return false; }
+
+    // Mix whole blocks of _blockFrames, whatever size irrKlang asks for, and hand them out as 16 bit.
+    irrklang::ik_s32 readFrames(void* target, irrklang::ik_s32 frameCountToRead)
+    {
+        int16_t* out = static_cast<int16_t*>(target);
+        size_t wanted = static_cast<size_t>(frameCountToRead);
+        while (wanted > 0) {
+            if (_blockPos == _blockFrames) {
+                _mixer.mix(&_block[0], _blockFrames);
+                _blockPos = 0;
+            }
+            size_t count = _blockFrames - _blockPos;
+            if (count > wanted) {
+                count = wanted;
+            }
+            floatToS16(&_block[_blockPos * 2], out, count * 2);
+            out += count * 2;
+            _blockPos += count;
+            wanted -= count;
+        }
+        return frameCountToRead;
+    }
+
+private:
+    Mixer& _mixer;
+    size_t _blockFrames;
+    std::vector<float> _block;
+    size_t _blockPos;
+};
+
+// Creates a MixerStream for mixerStreamName. Register it with ISoundEngine::registerAudioStreamLoader() and add a
+// MixerFileFactory, then play2D(mixerStreamName, true, false, false, ESM_STREAMING).
+class MixerStreamLoader : public irrklang::IAudioStreamLoader {
+public:
+    MixerStreamLoader(Mixer& mixer, size_t blockFrames)
+    : _mixer(mixer)
+    , _blockFrames(blockFrames)
+    {
+    }
+
+    bool isALoadableFileExtension(const irrklang::ik_c8* fileName)
+    {
+        return strcmp(fileName, mixerStreamName) == 0;
+    }
+
+    irrklang::IAudioStream* createAudioStream(irrklang::IFileReader* file)
+    {
+        return new MixerStream(_mixer, _blockFrames);
+    }
+
+private:
+    Mixer& _mixer;
+    size_t _blockFrames;
+};
+
+// irrKlang opens a file before handing it to a stream loader; this answers for mixerStreamName, which doesn't exist
+// on disk, with an empty file.
+class MixerFileFactory : public irrklang::IFileFactory {
+public:
+    irrklang::IFileReader* createFileReader(const irrklang::ik_c8* filename)
+    {
+        if (strcmp(filename, mixerStreamName) != 0) {
+            return 0;
+        }
+        static const unsigned char empty[1] = { 0 };
+        return new KitFileReader(filename, empty, 0);
+    }
+};
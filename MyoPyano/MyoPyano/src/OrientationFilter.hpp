@@ -0,0 +1,134 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <stdint.h>
+
+#include "../include/myo/myo.hpp"
+
+// OrientationFilter fuses the gyroscope and accelerometer with the armband's own orientation, Mahony style, and
+// extrapolates the result a few milliseconds ahead along the measured angular velocity.
+//
+// Each sample the gyroscope rate is integrated, after being nudged so that the gravity the estimate expects lines up
+// with what the accelerometer measures, which settles roll and pitch without the armband's smoothing lag. Gravity
+// says nothing about heading, so the estimate is also pulled a little towards the armband's orientation every
+// sample; that keeps it in the same world frame as the calibrated origin and stops the gyroscope's yaw drift from
+// accumulating. The predicted orientation is where the arm will be \a lead seconds after the last sample, which
+// covers the time from the sample to the sound actually playing.
+//
+// Every update is a fixed number of operations and nothing is allocated.
+class OrientationFilter {
+public:
+    OrientationFilter(float lead = 0.010f, float gravityGain = 2.0f, float deviceBlend = 0.02f)
+    : _lead(lead)
+    , _gravityGain(gravityGain)
+    , _deviceBlend(deviceBlend)
+    {
+        reset();
+    }
+
+    // Forget all state; the next update() starts again from the armband's orientation.
+    void reset()
+    {
+        _initialized = false;
+        _timestamp = 0;
+        _orientation = myo::Quaternion<float>();
+        _rate = myo::Vector3<float>(0, 0, 0);
+        _gravity = myo::Vector3<float>(0, 0, 1);
+    }
+
+    void setLead(float lead) { _lead = lead; }
+
+    // Feed one sample: the armband's \a device orientation, \a accel in g and \a gyro in deg/s, both in the
+    // armband's frame, as delivered together by the Hub.
+    void update(uint64_t timestamp, const myo::Quaternion<float>& device, const myo::Vector3<float>& accel,
+                const myo::Vector3<float>& gyro)
+    {
+        const float degrees = static_cast<float>(M_PI) / 180.0f;
+        _rate = myo::Vector3<float>(gyro.x() * degrees, gyro.y() * degrees, gyro.z() * degrees);
+
+        // Only trust the accelerometer as a gravity reading when the arm isn't accelerating much.
+        float g = accel.magnitude();
+        bool gravityOnly = g > 0.8f && g < 1.2f;
+
+        if (!_initialized) {
+            _orientation = device;
+            if (g > 0) {
+                _gravity = myo::rotate(device, accel).normalized();
+            }
+            _timestamp = timestamp;
+            _initialized = true;
+            return;
+        }
+
+        float dt = (timestamp - _timestamp) * 1e-6f;
+        _timestamp = timestamp;
+        if (dt <= 0 || dt > 0.1f) {
+            // A gap in the data; start over from the armband rather than integrate across it.
+            _orientation = device;
+            return;
+        }
+
+        myo::Vector3<float> rate = _rate;
+        if (gravityOnly) {
+            // Gravity in the world frame, learned slowly from the armband, so whichever way its world axes point
+            // doesn't matter.
+            myo::Vector3<float> measured(accel.x() / g, accel.y() / g, accel.z() / g);
+            myo::Vector3<float> world = myo::rotate(device, measured);
+            _gravity = myo::Vector3<float>(_gravity.x() * 0.99f + world.x() * 0.01f,
+                                           _gravity.y() * 0.99f + world.y() * 0.01f,
+                                           _gravity.z() * 0.99f + world.z() * 0.01f).normalized();
+
+            // Rotate towards the measured gravity by adding the cross product to the rate.
+            myo::Vector3<float> expected = myo::rotate(_orientation.conjugate(), _gravity);
+            myo::Vector3<float> error = measured.cross(expected);
+            rate = myo::Vector3<float>(rate.x() + _gravityGain * error.x(), rate.y() + _gravityGain * error.y(),
+                                       rate.z() + _gravityGain * error.z());
+        }
+        _orientation = integrate(_orientation, rate, dt);
+        _orientation = blend(_orientation, device, _deviceBlend);
+    }
+
+    bool initialized() const { return _initialized; }
+
+    // The filtered orientation at the last sample.
+    const myo::Quaternion<float>& orientation() const { return _orientation; }
+
+    // The orientation expected lead seconds after the last sample, assuming the arm keeps turning as it was.
+    myo::Quaternion<float> predicted() const
+    {
+        return integrate(_orientation, _rate, _lead);
+    }
+
+private:
+    // Turn \a q by the body rate \a rate (rad/s) for \a dt seconds.
+    static myo::Quaternion<float> integrate(const myo::Quaternion<float>& q, const myo::Vector3<float>& rate,
+                                            float dt)
+    {
+        float speed = rate.magnitude();
+        if (speed * dt < 1e-6f) {
+            return q;
+        }
+        myo::Vector3<float> axis(rate.x() / speed, rate.y() / speed, rate.z() / speed);
+        return (q * myo::Quaternion<float>::fromAxisAngle(axis, speed * dt)).normalized();
+    }
+
+    // Move \a from the fraction \a t of the way to \a to, along the shorter way round.
+    static myo::Quaternion<float> blend(const myo::Quaternion<float>& from, const myo::Quaternion<float>& to, float t)
+    {
+        float dot = from.x() * to.x() + from.y() * to.y() + from.z() * to.z() + from.w() * to.w();
+        float sign = dot < 0 ? -1.0f : 1.0f;
+        return myo::Quaternion<float>(from.x() * (1 - t) + to.x() * t * sign, from.y() * (1 - t) + to.y() * t * sign,
+                                      from.z() * (1 - t) + to.z() * t * sign, from.w() * (1 - t) + to.w() * t * sign)
+            .normalized();
+    }
+
+    float _lead;
+    float _gravityGain;
+    float _deviceBlend;
+    bool _initialized;
+    uint64_t _timestamp;
+    myo::Quaternion<float> _orientation;
+    myo::Vector3<float> _rate;
+    myo::Vector3<float> _gravity;
+};
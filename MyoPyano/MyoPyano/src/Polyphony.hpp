@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// How a new hit may claim a voice. Choke groups are bit masks: a hit stops every playing voice whose chokeGroup
+// shares a bit with its chokes mask, the way closing a hi-hat cuts off the open hi-hat still ringing.
+struct VoiceLimits {
+    VoiceLimits(int maxVoices = 0, unsigned int chokeGroup = 0, unsigned int chokes = 0)
+    : maxVoices(maxVoices)
+    , chokeGroup(chokeGroup)
+    , chokes(chokes)
+    {
+    }
+
+    // Most voices this pad may have playing at once, or 0 for no limit but the size of the pool.
+    int maxVoices;
+    unsigned int chokeGroup;
+    unsigned int chokes;
+};
+
+// Which voice to take over when the pool is full.
+enum VoiceStealing {
+    stealOldest,
+    stealQuietest
+};
+
+// The part of a voice that allocateVoice() looks at. Backends keep one per voice, next to whatever plays it.
+struct VoiceInfo {
+    int pad;
+    unsigned int chokeGroup;
+    float gain;
+    uint64_t startedAt;
+};
+
+// Pick the voice, out of \a count, that a new hit of \a pad should play on, and stop the voices it replaces.
+// \a isPlaying(i) tells whether voice i is still sounding and \a stop(i) silences it. Choked voices are stopped
+// first; then, if the pad is at its own limit, its oldest voice is reused; otherwise a free voice is used, or one
+// is stolen from the whole pool according to \a stealing. This is a linear pass over a small fixed pool, done once
+// per hit, so it never allocates.
+template <typename IsPlaying, typename Stop>
+size_t allocateVoice(VoiceInfo* voices, size_t count, int pad, const VoiceLimits& limits, VoiceStealing stealing,
+                     IsPlaying isPlaying, Stop stop)
+{
+    size_t freeVoice = count;
+    size_t padVoices = 0;
+    size_t oldestOfPad = count;
+    size_t victim = count;
+    for (size_t i = 0; i < count; i++) {
+        if (!isPlaying(i)) {
+            if (freeVoice == count) {
+                freeVoice = i;
+            }
+            continue;
+        }
+        if (voices[i].chokeGroup & limits.chokes) {
+            stop(i);
+            if (freeVoice == count) {
+                freeVoice = i;
+            }
+            continue;
+        }
+        if (voices[i].pad == pad) {
+            padVoices++;
+            if (oldestOfPad == count || voices[i].startedAt < voices[oldestOfPad].startedAt) {
+                oldestOfPad = i;
+            }
+        }
+        if (victim == count) {
+            victim = i;
+        } else if (stealing == stealQuietest && voices[i].gain != voices[victim].gain) {
+            if (voices[i].gain < voices[victim].gain) {
+                victim = i;
+            }
+        } else if (voices[i].startedAt < voices[victim].startedAt) {
+            victim = i;
+        }
+    }
+
+    size_t chosen;
+    if (limits.maxVoices > 0 && padVoices >= static_cast<size_t>(limits.maxVoices)) {
+        chosen = oldestOfPad;
+    } else if (freeVoice != count) {
+        return freeVoice;
+    } else {
+        chosen = victim;
+    }
+    stop(chosen);
+    return chosen;
+}
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <ctype.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+#include "../include/irrKlang/irrKlang.h"
+#include "MappedFile.hpp"
+#include "WavFile.hpp"
+
+// Index of a sample loaded into a SampleBank.
+typedef int SampleHandle;
+
+// Return the names of the regular files in \a directory, sorted. Returns an empty list if it can't be read.
+inline std::vector<std::string> listDirectory(const std::string& directory)
+{
+    std::vector<std::string> names;
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                names.push_back(data.cFileName);
+            }
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir) {
+        while (struct dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                names.push_back(entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+#endif
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// SampleBank loads every sample up front, fully decoded and never streamed, and hands out small integer handles for
+// them. Looking a handle up is an index into an array, so playing a sample costs the same from the first hit on,
+// with no file name lookup and no disk access. Samples are loaded at startup only; the bank is not thread-safe.
+//
+// Plain PCM WAV files are memory-mapped and irrKlang plays their sample data straight out of the mapping, so they
+// are neither read into a buffer nor copied. Other files go through irrKlang's own loaders. A bank can also be
+// filled from a KitArchive (see KitArchive.hpp), in which case every sample points into the archive's mapping.
+//
+// A bank made with no engine holds only plain PCM WAVs, parsed straight out of their mappings, for a Mixer to play
+// with no irrKlang at all; source() is then 0 and data() is the only way to the samples.
+class SampleBank {
+public:
+    static const SampleHandle invalidHandle = -1;
+
+    SampleBank(irrklang::ISoundEngine* engine)
+    : _engine(engine)
+    , _coldSamples(0)
+    {
+    }
+
+    // Removes the bank's samples from the engine, which stops any of them still playing, before unmapping them.
+    ~SampleBank()
+    {
+        for (size_t i = 0; _engine && i < _sources.size(); i++) {
+            _engine->removeSoundSource(_sources[i]);
+        }
+        for (size_t i = 0; i < _files.size(); i++) {
+            delete _files[i];
+        }
+    }
+
+    // Load every file in \a directory. Returns the number of samples that loaded.
+    size_t loadDirectory(const std::string& directory)
+    {
+        size_t loaded = 0;
+        std::vector<std::string> names = listDirectory(directory);
+        for (size_t i = 0; i < names.size(); i++) {
+            if (load(directory + "/" + names[i]) != invalidHandle) {
+                loaded++;
+            }
+        }
+        return loaded;
+    }
+
+    // Load a single sample, or return the handle it already has. Returns invalidHandle if it couldn't be loaded.
+    SampleHandle load(const std::string& fileName)
+    {
+        SampleHandle handle = find(fileName);
+        if (handle != invalidHandle) {
+            return handle;
+        }
+
+        WavData wav;
+        irrklang::ISoundSource* source = 0;
+        if (!loadMappedWav(fileName, wav, source)) {
+            // Anything but plain PCM needs irrKlang's decoders.
+            if (!_engine) {
+                return invalidHandle;
+            }
+            source = _engine->addSoundSourceFromFile(fileName.c_str(), irrklang::ESM_NO_STREAMING, true);
+            if (!source) {
+                return invalidHandle;
+            }
+
+            // irrKlang streams large files regardless of the mode asked for unless told otherwise, and only decodes
+            // a sample when it is first needed. Asking for the sample data makes it decode now.
+            source->setForcedStreamingThreshold(0);
+            if (!source->getSampleData()) {
+                _engine->removeSoundSource(source);
+                return invalidHandle;
+            }
+            wav = decodedData(source);
+        }
+
+        _sources.push_back(source);
+        _data.push_back(wav);
+        _names.push_back(fileName);
+        return static_cast<SampleHandle>(_sources.size() - 1);
+    }
+
+    // Add every entry of \a archive. The archive must stay open for as long as the bank exists. Samples are found
+    // by their entry names, but are registered with irrKlang under the archive's name as well, so several kits
+    // holding the same file names can be loaded side by side. Returns the number of samples that loaded.
+    template <typename Archive>
+    size_t loadArchive(const Archive& archive)
+    {
+        size_t loaded = 0;
+        for (size_t i = 0; i < archive.size(); i++) {
+            std::string name = archive.entryName(i);
+            if (find(name) != invalidHandle) {
+                continue;
+            }
+
+            std::string sourceName = archive.name() + ":" + name;
+            WavData wav;
+            irrklang::ISoundSource* source = 0;
+            if (!addPcm(archive.entryData(i), archive.entrySize(i), sourceName, wav, source)) {
+                if (!_engine) {
+                    continue;
+                }
+                // Not raw PCM; let irrKlang decode it, still without copying the file.
+                source = _engine->addSoundSourceFromMemory(const_cast<unsigned char*>(archive.entryData(i)),
+                                                           static_cast<irrklang::ik_s32>(archive.entrySize(i)),
+                                                           sourceName.c_str(), false);
+                if (!source) {
+                    continue;
+                }
+                source->setForcedStreamingThreshold(0);
+                source->setStreamMode(irrklang::ESM_NO_STREAMING);
+                if (!source->getSampleData()) {
+                    _engine->removeSoundSource(source);
+                    continue;
+                }
+                wav = decodedData(source);
+            }
+
+            _sources.push_back(source);
+            _data.push_back(wav);
+            _names.push_back(name);
+            loaded++;
+        }
+        return loaded;
+    }
+
+    // Return the handle of a loaded sample, comparing file names case-insensitively, or invalidHandle.
+    SampleHandle find(const std::string& fileName) const
+    {
+        for (size_t i = 0; i < _names.size(); i++) {
+            if (sameFileName(_names[i], fileName)) {
+                return static_cast<SampleHandle>(i);
+            }
+        }
+        return invalidHandle;
+    }
+
+    // The irrKlang sound source of a loaded sample, or 0 in a bank without an engine.
+    irrklang::ISoundSource* source(SampleHandle handle) const
+    {
+        return _sources[handle];
+    }
+
+    // The decoded sample data of a loaded sample and its format, with or without an engine.
+    const WavData& data(SampleHandle handle) const
+    {
+        return _data[handle];
+    }
+
+    const std::string& name(SampleHandle handle) const
+    {
+        return _names[handle];
+    }
+
+    size_t size() const
+    {
+        return _sources.size();
+    }
+
+    // The number of mapped samples whose pages weren't all in memory once they had been faulted in at load time. The
+    // first hit on any of them may still wait on the disk.
+    size_t coldSamples() const
+    {
+        return _coldSamples;
+    }
+
+private:
+    // Map a PCM WAV file into \a wav and add its sample data to the engine, if there is one, as \a source, without
+    // copying it. Returns false if the file can't be mapped or isn't a WAV that can be played as raw PCM.
+    bool loadMappedWav(const std::string& fileName, WavData& wav, irrklang::ISoundSource*& source)
+    {
+        MappedFile* file = new MappedFile();
+        if (!file->open(fileName) || !addPcm(file->data(), file->size(), fileName, wav, source)) {
+            delete file;
+            return false;
+        }
+
+        _files.push_back(file);
+        return true;
+    }
+
+    // Parse the WAV file held in \a data into \a wav and add its PCM data to the engine, if there is one, as
+    // \a source, without copying it. Returns false if it isn't a WAV that can be played as raw PCM.
+    bool addPcm(const unsigned char* data, size_t size, const std::string& sourceName, WavData& wav,
+                irrklang::ISoundSource*& source)
+    {
+        if (!parseWav(data, size, wav)) {
+            return false;
+        }
+
+        source = 0;
+        if (_engine) {
+            // The mapping is read-only; irrKlang only ever reads sample data it was told not to copy.
+            source = _engine->addSoundSourceFromPCMData(
+                const_cast<unsigned char*>(wav.pcm), static_cast<irrklang::ik_s32>(wav.pcmSize), sourceName.c_str(),
+                wav.format, false);
+            if (!source) {
+                return false;
+            }
+        }
+        // Fault the pages in now rather than on the first hit, and count the sample if the OS didn't keep them.
+        if (!MappedFile::prefault(wav.pcm, wav.pcmSize)) {
+            _coldSamples++;
+        }
+        return true;
+    }
+
+    // The sample data irrKlang decoded for \a source.
+    static WavData decodedData(irrklang::ISoundSource* source)
+    {
+        WavData wav;
+        wav.pcm = static_cast<const unsigned char*>(source->getSampleData());
+        wav.format = source->getAudioFormat();
+        wav.pcmSize = static_cast<size_t>(wav.format.getSampleDataSize());
+        return wav;
+    }
+
+    static bool sameFileName(const std::string& a, const std::string& b)
+    {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++) {
+            if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    irrklang::ISoundEngine* _engine;
+    std::vector<irrklang::ISoundSource*> _sources;
+    std::vector<WavData> _data;
+    std::vector<std::string> _names;
+
+    // Mappings backing the samples loaded by loadMappedWav(); owned by the bank.
+    std::vector<MappedFile*> _files;
+
+    size_t _coldSamples;
+
+    // Not implemented
+    SampleBank(const SampleBank&);
+    SampleBank& operator=(const SampleBank&);
+};
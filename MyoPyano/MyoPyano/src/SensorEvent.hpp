@@ -0,0 +1,238 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../include/myo/myo.hpp"
+
+// A SensorEvent is a fixed-size, already decoded copy of one event delivered by myo::Hub. It carries everything the
+// matching DeviceListener callback needs, so events can be handed from the thread running the Hub to another thread
+// and replayed there with dispatchSensorEvent().
+struct SensorEvent {
+    enum Type {
+        paired,
+        unpaired,
+        connected,
+        disconnected,
+        armSynced,
+        armUnsynced,
+        unlocked,
+        locked,
+        motion,  // One orientation sample together with the accelerometer and gyroscope readings of the same event.
+        pose,
+        emg,
+        warmupCompleted
+    };
+
+    uint32_t type;
+    myo::Myo* myo;
+    uint64_t timestamp;
+
+    // Valid for motion events.
+    float orientation[4]; // x, y, z, w
+    float accel[3];       // in units of g
+    float gyro[3];        // in units of deg/s
+
+    // Valid for paired and connected events.
+    unsigned int firmware[4];
+
+    // Valid for armSynced events.
+    int32_t arm;
+    int32_t xDirection;
+    int32_t warmupState;
+    float rotation;
+
+    // Valid for pose and warmupCompleted events.
+    int32_t poseType;
+    int32_t warmupResult;
+
+    // Valid for emg events.
+    int8_t emgData[8];
+};
+
+inline SensorEvent makeSensorEvent(SensorEvent::Type type, myo::Myo* myo, uint64_t timestamp)
+{
+    SensorEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.myo = myo;
+    event.timestamp = timestamp;
+    return event;
+}
+
+// Invoke the DeviceListener callback(s) corresponding to a recorded event, in the same order myo::Hub uses.
+inline void dispatchSensorEvent(myo::DeviceListener& listener, const SensorEvent& event)
+{
+    switch (event.type) {
+    case SensorEvent::paired:
+    case SensorEvent::connected: {
+        myo::FirmwareVersion version = { event.firmware[0], event.firmware[1], event.firmware[2], event.firmware[3] };
+        if (event.type == SensorEvent::paired) {
+            listener.onPair(event.myo, event.timestamp, version);
+        } else {
+            listener.onConnect(event.myo, event.timestamp, version);
+        }
+        break;
+    }
+    case SensorEvent::unpaired:
+        listener.onUnpair(event.myo, event.timestamp);
+        break;
+    case SensorEvent::disconnected:
+        listener.onDisconnect(event.myo, event.timestamp);
+        break;
+    case SensorEvent::armSynced:
+        listener.onArmSync(event.myo, event.timestamp,
+                           static_cast<myo::Arm>(event.arm),
+                           static_cast<myo::XDirection>(event.xDirection),
+                           event.rotation,
+                           static_cast<myo::WarmupState>(event.warmupState));
+        break;
+    case SensorEvent::armUnsynced:
+        listener.onArmUnsync(event.myo, event.timestamp);
+        break;
+    case SensorEvent::unlocked:
+        listener.onUnlock(event.myo, event.timestamp);
+        break;
+    case SensorEvent::locked:
+        listener.onLock(event.myo, event.timestamp);
+        break;
+    case SensorEvent::motion:
+        listener.onOrientationData(event.myo, event.timestamp,
+                                   myo::Quaternion<float>(event.orientation[0], event.orientation[1],
+                                                          event.orientation[2], event.orientation[3]));
+        listener.onAccelerometerData(event.myo, event.timestamp,
+                                     myo::Vector3<float>(event.accel[0], event.accel[1], event.accel[2]));
+        listener.onGyroscopeData(event.myo, event.timestamp,
+                                 myo::Vector3<float>(event.gyro[0], event.gyro[1], event.gyro[2]));
+        break;
+    case SensorEvent::pose:
+        listener.onPose(event.myo, event.timestamp, myo::Pose(static_cast<myo::Pose::Type>(event.poseType)));
+        break;
+    case SensorEvent::emg:
+        listener.onEmgData(event.myo, event.timestamp, event.emgData);
+        break;
+    case SensorEvent::warmupCompleted:
+        listener.onWarmupCompleted(event.myo, event.timestamp, static_cast<myo::WarmupResult>(event.warmupResult));
+        break;
+    }
+}
+
+// A DeviceListener that turns every Hub callback into a SensorEvent and hands it to onSensorEvent(), on the thread
+// running the Hub. Orientation, accelerometer and gyroscope data of one event arrive as three calls, in that order;
+// they are collected into a single motion event, handed over when the last one arrives.
+class SensorEventListener : public myo::DeviceListener {
+public:
+    SensorEventListener()
+    {
+        memset(&_pendingMotion, 0, sizeof(_pendingMotion));
+    }
+
+    virtual void onSensorEvent(const SensorEvent& event) = 0;
+
+    void onPair(myo::Myo* myo, uint64_t timestamp, myo::FirmwareVersion firmwareVersion)
+    {
+        SensorEvent event = makeSensorEvent(SensorEvent::paired, myo, timestamp);
+        setFirmware(event, firmwareVersion);
+        onSensorEvent(event);
+    }
+
+    void onUnpair(myo::Myo* myo, uint64_t timestamp)
+    {
+        onSensorEvent(makeSensorEvent(SensorEvent::unpaired, myo, timestamp));
+    }
+
+    void onConnect(myo::Myo* myo, uint64_t timestamp, myo::FirmwareVersion firmwareVersion)
+    {
+        SensorEvent event = makeSensorEvent(SensorEvent::connected, myo, timestamp);
+        setFirmware(event, firmwareVersion);
+        onSensorEvent(event);
+    }
+
+    void onDisconnect(myo::Myo* myo, uint64_t timestamp)
+    {
+        onSensorEvent(makeSensorEvent(SensorEvent::disconnected, myo, timestamp));
+    }
+
+    void onArmSync(myo::Myo* myo, uint64_t timestamp, myo::Arm arm, myo::XDirection xDirection, float rotation,
+                   myo::WarmupState warmupState)
+    {
+        SensorEvent event = makeSensorEvent(SensorEvent::armSynced, myo, timestamp);
+        event.arm = arm;
+        event.xDirection = xDirection;
+        event.rotation = rotation;
+        event.warmupState = warmupState;
+        onSensorEvent(event);
+    }
+
+    void onArmUnsync(myo::Myo* myo, uint64_t timestamp)
+    {
+        onSensorEvent(makeSensorEvent(SensorEvent::armUnsynced, myo, timestamp));
+    }
+
+    void onUnlock(myo::Myo* myo, uint64_t timestamp)
+    {
+        onSensorEvent(makeSensorEvent(SensorEvent::unlocked, myo, timestamp));
+    }
+
+    void onLock(myo::Myo* myo, uint64_t timestamp)
+    {
+        onSensorEvent(makeSensorEvent(SensorEvent::locked, myo, timestamp));
+    }
+
+    void onPose(myo::Myo* myo, uint64_t timestamp, myo::Pose pose)
+    {
+        SensorEvent event = makeSensorEvent(SensorEvent::pose, myo, timestamp);
+        event.poseType = pose.type();
+        onSensorEvent(event);
+    }
+
+    void onOrientationData(myo::Myo* myo, uint64_t timestamp, const myo::Quaternion<float>& quat)
+    {
+        _pendingMotion = makeSensorEvent(SensorEvent::motion, myo, timestamp);
+        _pendingMotion.orientation[0] = quat.x();
+        _pendingMotion.orientation[1] = quat.y();
+        _pendingMotion.orientation[2] = quat.z();
+        _pendingMotion.orientation[3] = quat.w();
+    }
+
+    void onAccelerometerData(myo::Myo* myo, uint64_t timestamp, const myo::Vector3<float>& accel)
+    {
+        _pendingMotion.accel[0] = accel.x();
+        _pendingMotion.accel[1] = accel.y();
+        _pendingMotion.accel[2] = accel.z();
+    }
+
+    void onGyroscopeData(myo::Myo* myo, uint64_t timestamp, const myo::Vector3<float>& gyro)
+    {
+        _pendingMotion.gyro[0] = gyro.x();
+        _pendingMotion.gyro[1] = gyro.y();
+        _pendingMotion.gyro[2] = gyro.z();
+        onSensorEvent(_pendingMotion);
+    }
+
+    void onEmgData(myo::Myo* myo, uint64_t timestamp, const int8_t* emg)
+    {
+        SensorEvent event = makeSensorEvent(SensorEvent::emg, myo, timestamp);
+        memcpy(event.emgData, emg, sizeof(event.emgData));
+        onSensorEvent(event);
+    }
+
+    void onWarmupCompleted(myo::Myo* myo, uint64_t timestamp, myo::WarmupResult warmupResult)
+    {
+        SensorEvent event = makeSensorEvent(SensorEvent::warmupCompleted, myo, timestamp);
+        event.warmupResult = warmupResult;
+        onSensorEvent(event);
+    }
+
+private:
+    static void setFirmware(SensorEvent& event, const myo::FirmwareVersion& version)
+    {
+        event.firmware[0] = version.firmwareVersionMajor;
+        event.firmware[1] = version.firmwareVersionMinor;
+        event.firmware[2] = version.firmwareVersionPatch;
+        event.firmware[3] = version.firmwareVersionHardwareRev;
+    }
+
+    // Only touched by the thread running the Hub.
+    SensorEvent _pendingMotion;
+};
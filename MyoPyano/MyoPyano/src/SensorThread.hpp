@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+#include "../include/myo/myo.hpp"
+#include "SensorEvent.hpp"
+#include "SpscRing.hpp"
+
+// SensorThread drives myo::Hub::run() on a dedicated thread and forwards every event it receives, already decoded,
+// through a lock-free single-producer/single-consumer ring. The consuming thread calls dispatch() to replay the
+// queued events into its own DeviceListener, so that listener is only ever touched by one thread and does not have
+// to wait for a Hub::run() slice to end before it sees a sample.
+class SensorThread : public SensorEventListener {
+public:
+    // An armband sends 50 motion events a second, each an orientation sample with its accelerometer and gyroscope
+    // readings, plus 200 EMG events a second while EMG is streamed. The ring holds two seconds of all of that from
+    // two armbands, 1000 events, rounded up to a power of two; without EMG the same ring lasts about ten seconds.
+    static const unsigned int motionEventsPerSecond = 50;
+    static const unsigned int emgEventsPerSecond = 200;
+    typedef SpscRing<SensorEvent, 1024> Ring;
+    static_assert(1024 >= (motionEventsPerSecond + emgEventsPerSecond) * 2 * 2,
+                  "SensorThread's ring must hold two seconds of events from two armbands");
+
+    SensorThread(myo::Hub& hub, unsigned int sliceMs = 1000/100)
+    : _hub(hub)
+    , _sliceMs(sliceMs)
+    , _running(false)
+    , _failed(false)
+    , _dropped(0)
+    , _waiting(false)
+    {
+    }
+
+    ~SensorThread()
+    {
+        stop();
+    }
+
+    // Register with the Hub and start the ingestion thread. The Hub must not be used by any other thread afterwards.
+    void start()
+    {
+        if (_running.exchange(true)) {
+            return;
+        }
+        _hub.addListener(this);
+        _thread = std::thread(&SensorThread::run, this);
+    }
+
+    void stop()
+    {
+        if (!_running.exchange(false)) {
+            return;
+        }
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+        _hub.removeListener(this);
+    }
+
+    // Called from the consuming thread. Replays every queued event into \a listener and returns how many there were.
+    // If the ingestion thread died because of an exception, that exception is rethrown here.
+    size_t dispatch(myo::DeviceListener& listener)
+    {
+        size_t count = 0;
+        SensorEvent event;
+        while (_ring.tryPop(event)) {
+            dispatchSensorEvent(listener, event);
+            count++;
+        }
+
+        if (count == 0 && _failed.load(std::memory_order_acquire)) {
+            _failed.store(false, std::memory_order_relaxed);
+            std::rethrow_exception(_error);
+        }
+
+        return count;
+    }
+
+    // Called from the consuming thread. Blocks until an event is queued, the ingestion thread fails, or \a timeoutMs
+    // milliseconds pass, so a consumer with nothing to do sleeps instead of spinning. The ingestion thread only takes
+    // the lock to wake a consumer that is actually waiting.
+    void waitForEvents(unsigned int timeoutMs)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _waiting.store(true, std::memory_order_relaxed);
+        // Pairs with the fence in onSensorEvent(): either the ingestion thread sees _waiting set and wakes us, or we
+        // see its event here and don't wait.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_ring.size() == 0 && !_failed.load(std::memory_order_acquire)) {
+            _wake.wait_for(lock, std::chrono::milliseconds(timeoutMs));
+        }
+        _waiting.store(false, std::memory_order_relaxed);
+    }
+
+    // Number of events thrown away: motion and EMG events that found the consumer too far behind, and any other
+    // event still waiting for room when the thread was stopped.
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    // Called on the ingestion thread, inside Hub::run().
+    //
+    // A motion or EMG event that finds the ring full is dropped, the newest rather than the oldest: only the consumer
+    // may take events off the ring, and blocking the Hub for a sample would hold up every armband. The consumer is
+    // two seconds behind by then, so it loses a stretch of samples and picks up again from the queued ones.
+    //
+    // Every other event changes what the collector knows about an armband, such as whether it is paired or which
+    // arm it is on, and is never dropped. These are rare, so the ingestion thread waits for room for them, in order
+    // with the samples around them, until the thread is stopped.
+    void onSensorEvent(const SensorEvent& event)
+    {
+        bool sample = event.type == SensorEvent::motion || event.type == SensorEvent::emg;
+        while (!_ring.tryPush(event)) {
+            if (sample || !_running.load(std::memory_order_relaxed)) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            wakeConsumer();
+            std::this_thread::yield();
+        }
+        wakeConsumer();
+    }
+
+private:
+    void run()
+    {
+        try {
+            while (_running.load(std::memory_order_relaxed)) {
+                _hub.run(_sliceMs);
+            }
+        } catch (...) {
+            // Hand the error over to the consumer, which rethrows it from dispatch().
+            _error = std::current_exception();
+            _failed.store(true, std::memory_order_release);
+            wakeConsumer();
+        }
+    }
+
+    // Wake the consumer if it is blocked in waitForEvents().
+    void wakeConsumer()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_waiting.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _wake.notify_one();
+        }
+    }
+
+    myo::Hub& _hub;
+    unsigned int _sliceMs;
+    std::thread _thread;
+    std::atomic<bool> _running;
+    std::atomic<bool> _failed;
+    std::exception_ptr _error;
+    std::atomic<uint64_t> _dropped;
+
+    // Set while the consumer is blocked in waitForEvents().
+    std::atomic<bool> _waiting;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+
+    Ring _ring;
+
+    // Not implemented
+    SensorThread(const SensorThread&);
+    SensorThread& operator=(const SensorThread&);
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// A fixed-size, lock-free ring buffer for exactly one producer thread and exactly one consumer thread.
+// Capacity must be a power of two so that wrapping an index is a single mask. The head and tail counters live on
+// separate cache lines so that the producer and the consumer never write to the same line.
+template <typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing()
+    : _head(0)
+    , _cachedTail(0)
+    , _tail(0)
+    , _cachedHead(0)
+    {
+    }
+
+    // Called from the producer thread only. Returns false, without blocking, if the ring is full.
+    bool tryPush(const T& item)
+    {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _cachedTail == Capacity) {
+            // Only refresh our view of the consumer's position when the ring looks full.
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head - _cachedTail == Capacity) {
+                return false;
+            }
+        }
+
+        _items[head & (Capacity - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Called from the consumer thread only. Returns false, without blocking, if the ring is empty.
+    bool tryPop(T& item)
+    {
+        std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _cachedHead) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail == _cachedHead) {
+                return false;
+            }
+        }
+
+        item = _items[tail & (Capacity - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate number of queued items; exact only when called while neither side is running.
+    std::size_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    static std::size_t capacity() { return Capacity; }
+
+private:
+    // Written by the producer.
+    alignas(64) std::atomic<std::size_t> _head;
+    std::size_t _cachedTail;
+
+    // Written by the consumer.
+    alignas(64) std::atomic<std::size_t> _tail;
+    std::size_t _cachedHead;
+
+    alignas(64) T _items[Capacity];
+
+    // Not implemented
+    SpscRing(const SpscRing&);
+    SpscRing& operator=(const SpscRing&);
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cmath>
+#include <stdint.h>
+
+#include "../include/myo/myo.hpp"
+
+// A single drum hit.
+struct Strike {
+    // Timestamp of the sample at which the hit was detected, in the same microsecond timebase as Hub events.
+    uint64_t timestamp;
+
+    // Peak downward angular velocity of the forearm during the swing, in deg/s. Zero if unknown.
+    float velocity;
+};
+
+// Rate, in deg/s, at which the forearm's pitch is decreasing (the stick is coming down), computed from one gyroscope
+// sample and the orientation delivered with it. The pitch is the same angle DataCollector derives from the
+// orientation, so this is its time derivative without any differencing of noisy angles. Independent of yaw.
+inline float downwardPitchRate(const myo::Quaternion<float>& orientation, const myo::Vector3<float>& gyro)
+{
+    // The armband reports angular velocity in its own frame; bring it into the world frame, along with the
+    // direction the forearm is pointing (the armband's x axis).
+    myo::Vector3<float> omega = myo::rotate(orientation, gyro);
+    myo::Vector3<float> forward = myo::rotate(orientation, myo::Vector3<float>(1, 0, 0));
+
+    // pitch = -asin(forward.z), so the downward rate is d(forward.z)/dt / cos(pitch) with d(forward)/dt = omega x forward.
+    float horizontal = std::sqrt(forward.x() * forward.x() + forward.y() * forward.y());
+    if (horizontal < 1e-3f) {
+        // Pointing straight up or down; the pitch rate is undefined there.
+        return 0;
+    }
+    return (omega.x() * forward.y() - omega.y() * forward.x()) / horizontal;
+}
+
+// StrikeDetector finds hits in a stream of downward angular velocity samples (see downwardPitchRate()). A swing
+// starts when the velocity exceeds the onset threshold, and the hit fires as soon as the velocity has peaked, either
+// by dropping clearly below the peak or by changing sign. That is several samples before the pitch angle itself
+// crosses any threshold, and the peak is a direct measure of how hard the hit was. After a hit the detector waits
+// for the velocity to fall below the release threshold before it accepts a new swing.
+class StrikeDetector {
+public:
+    StrikeDetector(float onsetThreshold = 150.0f, float releaseThreshold = 40.0f, float peakFraction = 0.85f)
+    : _onsetThreshold(onsetThreshold)
+    , _releaseThreshold(releaseThreshold)
+    , _peakFraction(peakFraction)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        _state = idle;
+        _peakVelocity = 0;
+        _peakTimestamp = 0;
+    }
+
+    // Feed one sample. Returns true and fills in \a strike if this sample completed a hit.
+    bool update(uint64_t timestamp, float velocity, Strike& strike)
+    {
+        switch (_state) {
+        case idle:
+            if (velocity > _onsetThreshold) {
+                _state = swinging;
+                _peakVelocity = velocity;
+                _peakTimestamp = timestamp;
+            }
+            break;
+        case swinging:
+            if (velocity >= _peakVelocity) {
+                _peakVelocity = velocity;
+                _peakTimestamp = timestamp;
+            } else if (velocity <= 0 || velocity < _peakVelocity * _peakFraction) {
+                strike.timestamp = _peakTimestamp;
+                strike.velocity = _peakVelocity;
+                _state = recovering;
+                return true;
+            }
+            break;
+        case recovering:
+            if (velocity < _releaseThreshold) {
+                _state = idle;
+            }
+            break;
+        }
+        return false;
+    }
+
+private:
+    enum State {
+        idle,
+        swinging,
+        recovering
+    };
+
+    float _onsetThreshold;
+    float _releaseThreshold;
+    float _peakFraction;
+
+    State _state;
+    float _peakVelocity;
+    uint64_t _peakTimestamp;
+};
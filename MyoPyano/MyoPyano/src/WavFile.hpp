@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../include/irrKlang/irrKlang.h"
+
+// The PCM sample data found inside a WAV file, and its format.
+struct WavData {
+    // Points into the buffer that was parsed; valid only as long as that buffer is.
+    const unsigned char* pcm;
+    size_t pcmSize;
+    irrklang::SAudioStreamFormat format;
+};
+
+inline uint32_t readLittleEndian32(const unsigned char* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint16_t readLittleEndian16(const unsigned char* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// Parse a RIFF/WAVE file held in memory. On success \a wav points at the PCM data inside \a data, without copying it.
+// Only uncompressed 8 and 16 bit PCM with one or two channels is accepted, since those are the formats irrKlang can
+// play from raw PCM; anything else returns false and should be loaded through irrKlang's own decoders instead.
+inline bool parseWav(const unsigned char* data, size_t size, WavData& wav)
+{
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    const unsigned char* fmt = 0;
+    uint32_t fmtSize = 0;
+    const unsigned char* pcm = 0;
+    uint32_t pcmSize = 0;
+
+    // Walk the chunk list. Chunks are word aligned, and other chunks (LIST, smpl, bext, ...) may appear anywhere.
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const unsigned char* chunk = data + pos;
+        uint32_t chunkSize = readLittleEndian32(chunk + 4);
+        size_t available = size - (pos + 8);
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunkSize < 16 || chunkSize > available) {
+                return false;
+            }
+            fmt = chunk + 8;
+            fmtSize = chunkSize;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            pcm = chunk + 8;
+            // Some writers leave a size that runs past the end of a truncated file; keep what is really there.
+            pcmSize = chunkSize > available ? static_cast<uint32_t>(available) : chunkSize;
+        }
+
+        if (chunkSize > available) {
+            break;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (!fmt || !pcm) {
+        return false;
+    }
+
+    uint16_t formatTag = readLittleEndian16(fmt);
+    uint16_t channels = readLittleEndian16(fmt + 2);
+    uint32_t sampleRate = readLittleEndian32(fmt + 4);
+    uint16_t bitsPerSample = readLittleEndian16(fmt + 14);
+
+    const uint16_t formatPcm = 1;
+    const uint16_t formatExtensible = 0xFFFE;
+    if (formatTag == formatExtensible) {
+        // The real format tag is the first two bytes of the sub-format GUID.
+        if (fmtSize < 40 || readLittleEndian16(fmt + 24) != formatPcm) {
+            return false;
+        }
+    } else if (formatTag != formatPcm) {
+        return false;
+    }
+
+    if ((channels != 1 && channels != 2) || (bitsPerSample != 8 && bitsPerSample != 16) || sampleRate == 0) {
+        return false;
+    }
+
+    wav.format.ChannelCount = channels;
+    wav.format.SampleRate = static_cast<irrklang::ik_s32>(sampleRate);
+    wav.format.SampleFormat = bitsPerSample == 8 ? irrklang::ESF_U8 : irrklang::ESF_S16;
+    wav.format.FrameCount = static_cast<irrklang::ik_s32>(pcmSize / wav.format.getFrameSize());
+    wav.pcm = pcm;
+    wav.pcmSize = static_cast<size_t>(wav.format.getSampleDataSize());
+    return wav.format.FrameCount > 0;
+}
+
+inline void writeLittleEndian32(unsigned char* p, uint32_t value)
+{
+    p[0] = static_cast<unsigned char>(value);
+    p[1] = static_cast<unsigned char>(value >> 8);
+    p[2] = static_cast<unsigned char>(value >> 16);
+    p[3] = static_cast<unsigned char>(value >> 24);
+}
+
+inline void writeLittleEndian16(unsigned char* p, uint16_t value)
+{
+    p[0] = static_cast<unsigned char>(value);
+    p[1] = static_cast<unsigned char>(value >> 8);
+}
+
+// Size of the header makeWavHeader() writes, which the PCM data directly follows.
+const size_t wavHeaderSize = 44;
+
+// Fill in the header of a 16 bit PCM WAV file with \a pcmSize bytes of data.
+inline void makeWavHeader(unsigned char* header, int channels, int sampleRate, uint32_t pcmSize)
+{
+    memcpy(header, "RIFF", 4);
+    writeLittleEndian32(header + 4, static_cast<uint32_t>(wavHeaderSize - 8) + pcmSize);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    writeLittleEndian32(header + 16, 16);
+    writeLittleEndian16(header + 20, 1);
+    writeLittleEndian16(header + 22, static_cast<uint16_t>(channels));
+    writeLittleEndian32(header + 24, static_cast<uint32_t>(sampleRate));
+    writeLittleEndian32(header + 28, static_cast<uint32_t>(sampleRate * channels * 2));
+    writeLittleEndian16(header + 32, static_cast<uint16_t>(channels * 2));
+    writeLittleEndian16(header + 34, 16);
+    memcpy(header + 36, "data", 4);
+    writeLittleEndian32(header + 40, pcmSize);
+}
@@ -0,0 +1,307 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "../include/myo/myo.hpp"
+
+// One zone of a layout: the pad played when the arm comes down with a corrected yaw in [fromYaw, toYaw) and a pitch
+// in [fromPitch, toPitch), all in degrees from the calibrated origin. A yaw range may wrap through 0, e.g. 320 to
+// 35; pitch runs from -90 (straight down) to 90 (straight up).
+struct Zone {
+    int number;
+    int pad;
+    int fromYaw;
+    int toYaw;
+    int fromPitch;
+    int toPitch;
+};
+
+// The direction the forearm points in, relative to the calibrated \a origin orientation: x is straight ahead, y is
+// to the left (the way yaw increases) and z is up (the way pitch increases). Like the Euler angles the zones were
+// written for, heading is measured about the world vertical and pitch is the elevation minus the origin's, so z is
+// the sine of the relative pitch. That is a unit vector unless the relative pitch is past vertical, where it is
+// clamped to straight up or down.
+inline myo::Vector3<float> armDirection(const myo::Quaternion<float>& orientation,
+                                        const myo::Quaternion<float>& origin)
+{
+    // Pitch is -asin(forward.z) in the Myo's world frame, so up is -z.
+    myo::Vector3<float> forward = myo::rotate(orientation, myo::Vector3<float>(1, 0, 0));
+    myo::Vector3<float> originForward = myo::rotate(origin, myo::Vector3<float>(1, 0, 0));
+    float up = -forward.z();
+    float level = std::sqrt(forward.x() * forward.x() + forward.y() * forward.y());
+    float originUp = -originForward.z();
+    float originLevel = std::sqrt(originForward.x() * originForward.x() + originForward.y() * originForward.y());
+
+    // Unit heading of the origin; calibrated pointing straight up or down, there is none, so use the world's.
+    float headingX = 1;
+    float headingY = 0;
+    if (originLevel > 1e-6f) {
+        headingX = originForward.x() / originLevel;
+        headingY = originForward.y() / originLevel;
+    }
+
+    // Sine and cosine of the elevation minus the origin's elevation.
+    float relativeUp = up * originLevel - level * originUp;
+    float relativeLevel = level * originLevel + up * originUp;
+    if (relativeLevel <= 0) {
+        return myo::Vector3<float>(0, 0, relativeUp < 0 ? -1.0f : 1.0f);
+    }
+
+    float scale = level > 1e-6f ? relativeLevel / level : 0;
+    return myo::Vector3<float>((forward.x() * headingX + forward.y() * headingY) * scale,
+                               (forward.y() * headingX - forward.x() * headingY) * scale,
+                               relativeUp);
+}
+
+// ZoneMap turns the corrected yaw and pitch of a strike into a zone with one table load. Each arm has a grid with a
+// cell per whole degree of yaw and per pitchStep degrees of pitch, filled once from a list of Zone, so a kit can
+// split each arm into any regions of the (yaw, pitch) plane without adding a single branch to a strike.
+//
+// Zones can also be found straight from an armDirection(), with no Euler angles at all. Each zone's edges are then
+// kept as unit vectors and sines, so the test is a few multiplies per zone, exact to well under a degree and
+// without a seam at 0/360 degrees.
+class ZoneMap {
+public:
+    static const size_t armCount = 2;
+    static const size_t maxZones = 64;
+    static const int minPitch = -90;
+    static const int maxPitch = 90;
+    static const int pitchStep = 5;
+    static const int pitchRows = (maxPitch - minPitch) / pitchStep;
+    static const uint8_t noZone = 0xFF;
+
+    ZoneMap()
+    {
+        memset(_table, noZone, sizeof(_table));
+        memset(_zoneCount, 0, sizeof(_zoneCount));
+    }
+
+    // Replace the zones of \a arm. Later zones win where zones overlap; cells no zone covers play nothing. Pitch
+    // bounds are rounded to the nearest pitchStep. Returns false, leaving the arm unchanged, if there are too many
+    // zones or an angle is out of range.
+    bool setZones(size_t arm, const Zone* zones, size_t count)
+    {
+        if (arm >= armCount || count > maxZones) {
+            return false;
+        }
+        for (size_t z = 0; z < count; z++) {
+            if (zones[z].fromYaw < 0 || zones[z].fromYaw > 360 || zones[z].toYaw < 0 || zones[z].toYaw > 360 ||
+                zones[z].fromPitch < minPitch || zones[z].toPitch > maxPitch || zones[z].fromPitch >= zones[z].toPitch) {
+                return false;
+            }
+        }
+
+        memset(_table[arm], noZone, sizeof(_table[arm]));
+        for (size_t z = 0; z < count; z++) {
+            _zones[arm][z] = zones[z];
+            _edges[arm][z] = ZoneEdges(zones[z]);
+
+            // 0 to 360 is the whole circle, not an empty zone.
+            int span = wrapDegrees(zones[z].toYaw - zones[z].fromYaw);
+            if (span == 0 && zones[z].toYaw != zones[z].fromYaw) {
+                span = 360;
+            }
+            for (int row = 0; row < pitchRows; row++) {
+                // A row belongs to the zone if its centre does; twice the angles keeps the centre whole.
+                int centre = 2 * (minPitch + row * pitchStep) + pitchStep;
+                if (centre < 2 * zones[z].fromPitch || centre >= 2 * zones[z].toPitch) {
+                    continue;
+                }
+                for (int i = 0; i < span; i++) {
+                    _table[arm][row][wrapDegrees(zones[z].fromYaw + i)] = static_cast<uint8_t>(z);
+                }
+            }
+        }
+        _zoneCount[arm] = count;
+        return true;
+    }
+
+    // The zone \a arm points into at corrected \a yaw and \a pitch, in degrees, or 0 if none. Pitches beyond
+    // straight up or down count as straight up or down.
+    const Zone* find(size_t arm, int yaw, int pitch) const
+    {
+        int row = (pitch - minPitch) / pitchStep;
+        if (pitch < minPitch) {
+            row = 0;
+        } else if (row >= pitchRows) {
+            row = pitchRows - 1;
+        }
+        uint8_t zone = _table[arm][row][wrapDegrees(yaw)];
+        return zone == noZone ? 0 : &_zones[arm][zone];
+    }
+
+    // The zone \a arm points into when its armDirection() is \a direction, or 0 if none. Later zones win where zones
+    // overlap, as they do in the table.
+    const Zone* find(size_t arm, const myo::Vector3<float>& direction) const
+    {
+        for (size_t z = _zoneCount[arm]; z-- > 0;) {
+            if (_edges[arm][z].contains(direction)) {
+                return &_zones[arm][z];
+            }
+        }
+        return 0;
+    }
+
+    size_t zoneCount(size_t arm) const { return _zoneCount[arm]; }
+
+    const Zone& zone(size_t arm, size_t index) const { return _zones[arm][index]; }
+
+    static int wrapDegrees(int degrees)
+    {
+        degrees %= 360;
+        return degrees < 0 ? degrees + 360 : degrees;
+    }
+
+private:
+    // A zone's edges as directions: the yaw edges as unit vectors in the horizontal plane, and the pitch edges as the
+    // sine of the pitch, which is the up component of a unit direction.
+    struct ZoneEdges {
+        ZoneEdges()
+        {
+        }
+
+        ZoneEdges(const Zone& zone)
+        {
+            const float degrees = static_cast<float>(M_PI) / 180.0f;
+            fromX = std::cos(zone.fromYaw * degrees);
+            fromY = std::sin(zone.fromYaw * degrees);
+            toX = std::cos(zone.toYaw * degrees);
+            toY = std::sin(zone.toYaw * degrees);
+            int span = wrapDegrees(zone.toYaw - zone.fromYaw);
+            fullCircle = span == 0 && zone.toYaw != zone.fromYaw;
+            wide = span > 180;
+            minUp = zone.fromPitch <= minPitch ? -2.0f : std::sin(zone.fromPitch * degrees);
+            maxUp = zone.toPitch >= maxPitch ? 2.0f : std::sin(zone.toPitch * degrees);
+        }
+
+        bool contains(const myo::Vector3<float>& direction) const
+        {
+            if (direction.z() < minUp || direction.z() >= maxUp) {
+                return false;
+            }
+            if (fullCircle) {
+                return true;
+            }
+            // Inside a wedge of at most 180 degrees means counterclockwise of its first edge and clockwise of its
+            // last; a wider wedge is everything outside the narrow one between its ends.
+            float x = direction.x();
+            float y = direction.y();
+            if (wide) {
+                return !(toX * y - toY * x >= 0 && x * fromY - y * fromX > 0);
+            }
+            return fromX * y - fromY * x >= 0 && x * toY - y * toX > 0;
+        }
+
+        float fromX;
+        float fromY;
+        float toX;
+        float toY;
+        float minUp;
+        float maxUp;
+        bool fullCircle;
+        bool wide;
+    };
+
+    uint8_t _table[armCount][pitchRows][360];
+    Zone _zones[armCount][maxZones];
+    ZoneEdges _edges[armCount][maxZones];
+    size_t _zoneCount[armCount];
+};
+
+// Load a zone layout from \a fileName into \a map. The file is plain text, one zone per line:
+//
+//   # arm   zone  pad      yaw from  to   [pitch from  to]
+//   right   1     crash    35        150  10           90
+//   left    2     tom1     320       40
+//
+// Blank lines and anything after '#' are ignored. Pads are named by \a padKeys, whose index is the pad number, and
+// a zone without a pitch range covers all pitches. An arm the file doesn't mention keeps its zones. Returns false
+// with a message in \a error if the file can't be read or a line doesn't make sense; \a map is then unchanged.
+inline bool loadZoneLayout(const std::string& fileName, const char* const* padKeys, int padCount, ZoneMap& map,
+                           std::string& error)
+{
+    std::ifstream file(fileName.c_str());
+    if (!file) {
+        error = "Unable to open zone layout " + fileName;
+        return false;
+    }
+
+    std::vector<Zone> zones[ZoneMap::armCount];
+    bool mentioned[ZoneMap::armCount] = { false, false };
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++) {
+        std::string::size_type comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream fields(line);
+        std::string armName;
+        if (!(fields >> armName)) {
+            continue;
+        }
+
+        std::ostringstream where;
+        where << fileName << ":" << lineNumber << ": ";
+
+        size_t arm;
+        if (armName == "right") {
+            arm = 0;
+        } else if (armName == "left") {
+            arm = 1;
+        } else {
+            error = where.str() + "expected 'right' or 'left', not '" + armName + "'";
+            return false;
+        }
+
+        Zone zone;
+        std::string padName;
+        if (!(fields >> zone.number >> padName >> zone.fromYaw >> zone.toYaw)) {
+            error = where.str() + "expected zone number, pad and yaw range";
+            return false;
+        }
+        zone.pad = -1;
+        for (int pad = 0; pad < padCount; pad++) {
+            if (padName == padKeys[pad]) {
+                zone.pad = pad;
+            }
+        }
+        if (zone.pad < 0) {
+            error = where.str() + "unknown pad '" + padName + "'";
+            return false;
+        }
+        if (!(fields >> zone.fromPitch)) {
+            zone.fromPitch = ZoneMap::minPitch;
+            zone.toPitch = ZoneMap::maxPitch;
+        } else if (!(fields >> zone.toPitch)) {
+            error = where.str() + "expected the end of the pitch range";
+            return false;
+        }
+
+        mentioned[arm] = true;
+        zones[arm].push_back(zone);
+    }
+
+    // Check every arm before touching the map, so a bad file changes nothing.
+    ZoneMap check;
+    for (size_t arm = 0; arm < ZoneMap::armCount; arm++) {
+        if (mentioned[arm] && !check.setZones(arm, &zones[arm][0], zones[arm].size())) {
+            error = fileName + ": too many zones, or an angle out of range, for the " + (arm == 0 ? "right" : "left") +
+                    " arm";
+            return false;
+        }
+    }
+    for (size_t arm = 0; arm < ZoneMap::armCount; arm++) {
+        if (mentioned[arm]) {
+            map.setZones(arm, &zones[arm][0], zones[arm].size());
+        }
+    }
+    return true;
+}
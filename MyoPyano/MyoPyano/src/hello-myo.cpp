@@ -4,273 +4,218 @@
 #include <cmath>
 #include <iostream>
 #include <stdio.h>
+#include <stdlib.h>
 #include <iomanip>
 #include <stdexcept>
 #include <string>
+#include <string.h>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 // The only file that needs to be included to use the Myo C++ SDK is myo.hpp.
 
-#include "..\include\myo\myo.hpp"
+#include "../include/myo/myo.hpp"
 #include "../include/irrKlang/irrKlang.h"
+#include "AsyncLog.hpp"
+#include "AudioOutput.hpp"
+#include "DataCollector.hpp"
+#include "EventRecorder.hpp"
+#include "EventReplay.hpp"
+#include "KitArchive.hpp"
+#include "MetricsReporter.hpp"
+#include "MixerStream.hpp"
+#include "SensorThread.hpp"
+
+// Returns true if \a flag was given on the command line.
+bool hasFlag(int argc, char** argv, const char* flag)
+{
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], flag) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
 
-// Classes that inherit from myo::DeviceListener can be used to receive events from Myo devices. DeviceListener
-// provides several virtual functions for handling different kinds of events. If you do not override an event, the
-// default behavior is to do nothing.
-class DataCollector : public myo::DeviceListener {
-public:
-    DataCollector()
-		:roll_w(0), pitch_w(0), yaw_w(0), origin_roll(0), origin_pitch(0), origin_yaw(0), currentPose(), whichArm(0)
-    {
-		roll_w = { 0, 0 };
-		pitch_w = { 0, 0 };
-		yaw_w = { 0, 0 };
-		origin_roll = { 0, 0 };
-		origin_pitch = { 0, 0 };
-		origin_yaw = { 0, 0 };
-		onArm[0] = false;
-		onArm[1] = false;
-		isUnlocked[0] = false;
-		isUnlocked[1] = false;
-		currentPose = { myo::Pose::unknown, myo::Pose::unknown };
-		whichArm = { myo::armUnknown, myo::armUnknown };
-    }
-
-	void onPair(myo::Myo* myo, uint64_t timestamp, myo::FirmwareVersion firmwareVersion)
-	{
-		// Print out the MAC address of the armband we paired with.
-
-		// The pointer address we get for a Myo is unique - in other words, it's safe to compare two Myo pointers to
-		// see if they're referring to the same Myo.
-
-		// Add the Myo pointer to our list of known Myo devices. This list is used to implement identifyMyo() below so
-		// that we can give each Myo a nice short identifier.
-		knownMyos.push_back(myo);
-
-		// Now that we've added it to our list, get our short ID for it and print it out.
-		std::cout << "Paired with " << identifyMyo(myo) << "." << std::endl;
+// Returns the argument following \a flag on the command line, or a null pointer if it wasn't given.
+const char* flagValue(int argc, char** argv, const char* flag)
+{
+	for (int i = 1; i + 1 < argc; i++) {
+		if (strcmp(argv[i], flag) == 0) {
+			return argv[i + 1];
+		}
 	}
+	return 0;
+}
 
-    // onUnpair() is called whenever the Myo is disconnected from Myo Connect by the user.
-	void onUnpair(myo::Myo* myo, uint64_t timestamp)
-	{
-		// We've lost a Myo.
-		// Let's clean up some leftover state.
-		roll_w = {0, 0};
-        pitch_w = { 0, 0 };
-        yaw_w = { 0, 0 };
-		origin_roll = { 0, 0 };
-		origin_pitch = { 0, 0 };
-		origin_yaw = { 0, 0 };
-		onArm[0] = false;
-		onArm[1] = false;
-		isUnlocked[0] = false;
-		isUnlocked[1] = false;
-    }
+int main(int argc, char** argv)
+{
+    // We catch any exceptions that might occur below -- see the catch statement for more details.
+    try {
 
-    // onOrientationData() is called whenever the Myo device provides its current orientation, which is represented
-    // as a unit quaternion.
-    void onOrientationData(myo::Myo* myo, uint64_t timestamp, const myo::Quaternion<float>& quat)
-    {
-        using std::atan2;
-        using std::asin;
-        using std::sqrt;
-        using std::max;
-        using std::min;
-
-		int myoIndex = identifyMyo(myo);
-
-		//std::cout << "w: " << quat.w() << " x: " << quat.x() << " y: " << quat.y() << " z: " << quat.z() << "\n";
-        // Calculate Euler angles (roll, pitch, and yaw) from the unit quaternion.
-        float roll = atan2(2.0f * (quat.w() * quat.x() + quat.y() * quat.z()),
-                           1.0f - 2.0f * (quat.x() * quat.x() + quat.y() * quat.y()));
-		float pitch = asin(max(-1.0f, min(1.0f, 2.0f * (quat.w() * quat.y() - quat.z() * quat.x()))));
-		float yaw = atan2(2.0f * (quat.w() * quat.z() + quat.x() * quat.y()),
-                        1.0f - 2.0f * (quat.y() * quat.y() + quat.z() * quat.z()));
-		
-		if (origin_pitch[myoIndex] == 0)
-		{
-			origin_roll[myoIndex] = static_cast<int>((roll + (float)M_PI) / (M_PI * 2.0f) * 359);
-			origin_pitch[myoIndex] = static_cast<int>((pitch + (float)M_PI / 2.0f) / M_PI * 359);
-			origin_yaw[myoIndex] = static_cast<int>((yaw + (float)M_PI) / (M_PI * 2.0f) * 359);
-		}
+	// With --sensor-thread the Hub is run on its own thread and samples reach the strike logic through a lock-free
+	// queue as soon as they arrive, instead of once per hub.run() slice.
+	bool useSensorThread = hasFlag(argc, argv, "--sensor-thread");
 
-        // Convert the floating point angles in radians to a scale from 0 to 18.
-        roll_w[myoIndex] = static_cast<int>((roll + (float)M_PI)/(M_PI * 2.0f) * 359);
-        pitch_w[myoIndex] = static_cast<int>((pitch + (float)M_PI/2.0f)/M_PI * 359);
-        yaw_w[myoIndex] = static_cast<int>((yaw + (float)M_PI)/(M_PI * 2.0f) * 359);
-    }
+	// Strikes are detected from the gyroscope unless --pitch-strikes asks for the older pitch threshold test.
+	bool gyroStrikes = !hasFlag(argc, argv, "--pitch-strikes");
 
-    // onPose() is called whenever the Myo detects that the person wearing it has changed their pose, for example,
-    // making a fist, or not making a fist anymore.
-    void onPose(myo::Myo* myo, uint64_t timestamp, myo::Pose pose)
-    {
-		int myoIndex = identifyMyo(myo);
-        currentPose[myoIndex] = pose;
-
-        /*if (pose != myo::Pose::unknown && pose != myo::Pose::rest) {
-            // Tell the Myo to stay unlocked until told otherwise. We do that here so you can hold the poses without the
-            // Myo becoming locked.
-            myo->unlock(myo::Myo::unlockHold);
-
-            // Notify the Myo that the pose has resulted in an action, in this case changing
-            // the text on the screen. The Myo will vibrate.
-            myo->notifyUserAction();
-        } else {
-            // Tell the Myo to stay unlocked only for a short period. This allows the Myo to stay unlocked while poses
-            // are being performed, but lock after inactivity.
-            myo->unlock(myo::Myo::unlockTimed);
-        }*/
-		std::cout << pose;
-		if (pose == myo::Pose::fist)
-		{
-			std::cout << "fist";
-			origin_pitch[myoIndex] = 0;
-			origin_roll[myoIndex] = 0;
-			origin_yaw[myoIndex] = 0;
+	// --pack-kit <file> packs the Sounds directory into a kit archive that --kit <file> can load in one go.
+	if (const char* packKit = flagValue(argc, argv, "--pack-kit")) {
+		if (!writeKitArchive("Sounds", packKit)) {
+			throw std::runtime_error(std::string("Unable to write kit archive ") + packKit);
 		}
-    }
+		std::cout << "Packed Sounds into " << packKit << "." << std::endl;
+		return 0;
+	}
+	const char* kitName = flagValue(argc, argv, "--kit");
 
-    // onArmSync() is called whenever Myo has recognized a Sync Gesture after someone has put it on their
-    // arm. This lets Myo know which arm it's on and which way it's facing.
-    void onArmSync(myo::Myo* myo, uint64_t timestamp, myo::Arm arm, myo::XDirection xDirection, float rotation,
-                   myo::WarmupState warmupState)
-    {
-		int myoIndex = identifyMyo(myo);
-        onArm[myoIndex] = true;
-        whichArm[myoIndex] = arm;
-    }
+	// --direction-zones finds the zone from the direction the arm points in instead of from Euler angles.
+	bool directionZones = hasFlag(argc, argv, "--direction-zones");
 
-    // onArmUnsync() is called whenever Myo has detected that it was moved from a stable position on a person's arm after
-    // it recognized the arm. Typically this happens when someone takes Myo off of their arm, but it can also happen
-    // when Myo is moved around on the arm.
-    void onArmUnsync(myo::Myo* myo, uint64_t timestamp)
-    {
-		int myoIndex = identifyMyo(myo);
-        onArm[myoIndex] = false;
-    }
+	// --fusion fuses the gyroscope and accelerometer into the orientation and looks --fusion-lead <ms> ahead (10 by
+	// default) when choosing the zone of a strike.
+	bool fusion = hasFlag(argc, argv, "--fusion");
+	const char* fusionLead = flagValue(argc, argv, "--fusion-lead");
 
-    // onUnlock() is called whenever Myo has become unlocked, and will start delivering pose events.
-    void onUnlock(myo::Myo* myo, uint64_t timestamp)
-    {
-		int myoIndex = identifyMyo(myo);
-        isUnlocked[myoIndex] = true;
-    }
+	// --layout <file> replaces the default zones with a zone layout file, e.g. Layouts/two-tier.txt.
+	const char* layoutName = flagValue(argc, argv, "--layout");
 
-    // onLock() is called whenever Myo has become locked. No pose events will be sent until the Myo is unlocked again.
-    void onLock(myo::Myo* myo, uint64_t timestamp)
-    {
-		int myoIndex = identifyMyo(myo);
-        isUnlocked[myoIndex] = false;
-    }
+	// --record <file> writes every event the Hub delivers to an event log.
+	const char* recordName = flagValue(argc, argv, "--record");
 
-    // There are other virtual functions in DeviceListener that we could override here, like onAccelerometerData().
-    // For this example, the functions overridden above are sufficient.
-
-    // We define this function to print the current values that were updated by the on...() functions above.
-    void print()
-    {
-		for (int i = 0; i < knownMyos.size(); i++)
-		{
-			// Clear the current line
-			std::cout << '\n';
-
-			// Print out the orientation. Orientation data is always available, even if no arm is currently recognized.
-			/*std::cout << "[ Roll: " << std::roll_w, '*') << std::string(18 - roll_w, ' ') << ']'
-			<< "[ Pitch: " << std::string(pitch_w, '*') << std::string(18 - pitch_w, ' ') << ']'
-			<< "[ Yaw : " << std::string(yaw_w, '*') << std::string(18 - yaw_w, ' ') << ']';
-			*/
-			std::cout << i << "[ Roll: " << roll_w[i] << "] [ Pitch: " << pitch_w[i] << " ] [ Yaw: " << yaw_w[i] << " ]";
-		
-			if (onArm[i]){
-				// Print out the lock state, the currently recognized pose, and which arm Myo is being worn on.
-
-				// Pose::toString() provides the human-readable name of a pose. We can also output a Pose directly to an
-				// output stream (e.g. std::cout << currentPose;). In this case we want to get the pose name's length so
-				// that we can fill the rest of the field with spaces below, so we obtain it as a string using toString().
-				std::string poseString = currentPose[i].toString();
-
-				/*std::cout << '[' << (isUnlocked[i] ? "unlocked" : "locked  ") << ']'
-					<< '[' << (whichArm[i] == myo::armLeft ? "L" : "R") << ']'
-					<< '[' << poseString << std::string(14 - poseString.size(), ' ') << ']';*/
-			}
-			else {
-				// Print out a placeholder for the arm and pose when Myo doesn't currently know which arm it's on.
-				std::cout << '[' << std::string(8, ' ') << ']' << "[?]" << '[' << std::string(14, ' ') << ']';
-			}
-		}
-		std::cout << "\n";
-        std::cout << std::flush;
-    }
+	// --replay <file> plays back an event log made with --record instead of listening to a Myo.
+	const char* replayName = flagValue(argc, argv, "--replay");
 
-	void printRight()
-	{
-		
-			// Clear the current line
-		std::cout << '\n';
-		std::cout << "Right Arm: [ Roll: " << roll_w[0] << "] [ Pitch: " << pitch_w[0] << " ] [ Yaw: " << yaw_w[0] << " ]";
-		//std::cout << "\n";
-		std::cout << std::flush;
-	}
-	void printLeft()
-	{
-
-		// Clear the current line
-		std::cout << '\n';
-		std::cout << "Left Arm: [ Roll: " << roll_w[1] << "] [ Pitch: " << pitch_w[1] << " ] [ Yaw: " << yaw_w[1] << " ]";
-		//std::cout << "\n";
-		std::cout << std::flush;
+	// --mixer plays the drums through our own mixer, in blocks of --mixer-block <frames>, instead of one irrKlang
+	// sound per hit.
+	bool useMixer = hasFlag(argc, argv, "--mixer");
+	const char* mixerBlock = flagValue(argc, argv, "--mixer-block");
+	int mixerBlockFrames = mixerBlock ? atoi(mixerBlock) : 64;
+	if (mixerBlockFrames <= 0) {
+		throw std::runtime_error("--mixer-block needs a positive number of frames");
 	}
 
-	size_t identifyMyo(myo::Myo* myo) {
-		// Walk through the list of Myo devices that we've seen pairing events for.
-		for (size_t i = 0; i < knownMyos.size(); i++) {
-			// If two Myo pointers compare equal, they refer to the same Myo device.
-			if (knownMyos[i] == myo) {
-				return i;
-			}
-		}
-
-		return 0;
+	// --metrics <seconds> prints what the collector and the mixer have been doing every <seconds>.
+	const char* metricsInterval = flagValue(argc, argv, "--metrics");
+
+	// --headless mixes without a sound device, on a clock of its own, and --wav <file> (which implies it) keeps what
+	// was mixed. Either implies --mixer. A build with PYANO_NO_IRRKLANG defined, which needs no irrKlang library,
+	// is always headless.
+	const char* wavName = flagValue(argc, argv, "--wav");
+#ifdef PYANO_NO_IRRKLANG
+	bool headless = true;
+#else
+	bool headless = hasFlag(argc, argv, "--headless") || wavName;
+#endif
+	useMixer = useMixer || headless;
+
+	// start the sound engine with default parameters. Headless there is no engine at all: the samples are parsed
+	// straight from their WAV files into the mixer.
+	irrklang::ISoundEngine* engine = 0;
+#ifndef PYANO_NO_IRRKLANG
+	if (!headless) {
+		engine = irrklang::createIrrKlangDevice();
+		if (!engine)
+			return 0; // error starting up the engine
 	}
+#endif
+	char* sounds[2][4] = { {"Sounds/909_snr2.wav", "Sounds/crash_cymbals.wav", "Sounds/bassdr04.wav", "Sounds/hh4.wav"},{ "Sounds/a.wav", "Sounds/b.wav", "Sounds/c.wav", "Sounds/d.wav"} };
 
-	// We store each Myo pointer that we pair with in this list, so that we can keep track of the order we've seen
-	// each Myo and give it a unique short identifier (see onPair() and identifyMyo() above).
-	std::vector<myo::Myo*> knownMyos;
-
-    // These values are set by onArmSync() and onArmUnsync() above.
-	bool onArm[2];
-	std::vector<myo::Arm> whichArm;
-
-    // This is set by onUnlocked() and onLocked() above.
-	bool isUnlocked[2];
-
-    // These values are set by onOrientationData() and onPose() above.
-	std::vector<int> roll_w, pitch_w, yaw_w;
-	std::vector<int> origin_roll, origin_pitch, origin_yaw;
-	std::vector<myo::Pose> currentPose;
-};
-
-int correction(int cv, int no) {
-	if (cv >= no) {
-		return cv - no;
+	// Load and decode every sample before the first hit, so no hit ever waits on the disk. A kit archive is mapped
+	// once and also serves any file irrKlang itself opens by name. Without an engine only plain PCM WAVs load.
+	KitArchive archive;
+	SampleBank bank(engine);
+	if (kitName) {
+		if (!archive.open(kitName)) {
+			throw std::runtime_error(std::string("Unable to open kit archive ") + kitName);
+		}
+		if (engine) {
+			KitFileFactory* factory = new KitFileFactory(&archive);
+			engine->addFileFactory(factory);
+			factory->drop();
+		}
+		std::cout << "Loaded " << bank.loadArchive(archive) << " samples from " << kitName << "." << std::endl;
 	}
 	else {
-		return cv + (360 - no);
+		std::cout << "Loaded " << bank.loadDirectory("Sounds") << " samples." << std::endl;
+	}
+	if (bank.coldSamples() != 0) {
+		std::cout << bank.coldSamples() << " samples could not be kept in memory; their first hits may stall."
+		          << std::endl;
 	}
-}
 
-int main(int argc, char** argv)
-{
-    // We catch any exceptions that might occur below -- see the catch statement for more details.
-    try {
+    // Next we construct an instance of our DeviceListener, so that we can register it with the Hub. The collector
+    // detects strikes itself and hands them to the drum kit, which plays the sound.
+    DrumKit kit(engine, bank);
+    if (layoutName) {
+        std::string error;
+        if (!kit.loadLayout(layoutName, error)) {
+            throw std::runtime_error(error);
+        }
+    }
+    DataCollector<PolynomialTrig> collector(kit, gyroStrikes, directionZones);
+
+    // Everything printed on a strike goes through the log, so the drum never waits on the console.
+    AsyncLog log(std::cout);
+    collector.useLog(&log);
+    kit.useLog(&log);
+    if (fusion || fusionLead) {
+        collector.enableFusion((fusionLead ? static_cast<float>(atof(fusionLead)) : 10.0f) / 1000.0f);
+    }
 
-	// start the sound engine with default parameters
-	irrklang::ISoundEngine* engine = irrklang::createIrrKlangDevice();
-	char* sounds[2][4] = { {"Sounds/909_snr2.wav", "Sounds/crash_cymbals.wav", "Sounds/bassdr04.wav", "Sounds/hh4.wav"},{ "Sounds/a.wav", "Sounds/b.wav", "Sounds/c.wav", "Sounds/d.wav"} };
+    // Strikes only queue a trigger for the mixer; the output pulls the mix from it, either as one endless irrKlang
+    // stream or on the headless clock.
+    Mixer mixer(44100, mixerBlockFrames);
+
+    // The collector and the mixer each keep their own metrics, on their own threads; the reporter only reads them.
+    CollectorMetrics metrics;
+    MixerMetrics mixerMetrics;
+    MetricsReporter reporter(metrics, useMixer ? &mixerMetrics : 0, std::cout);
+    if (metricsInterval) {
+        collector.useMetrics(&metrics);
+        mixer.useMetrics(&mixerMetrics);
+        reporter.start(std::max(0.1, atof(metricsInterval)));
+    }
 
-	if (!engine)
-		return 0; // error starting up the engine
+    IrrKlangOutput deviceOutput(engine, mixer, mixerBlockFrames);
+    HeadlessOutput headlessOutput(mixer, mixerBlockFrames);
+    if (wavName && !headlessOutput.openWav(wavName)) {
+        throw std::runtime_error(std::string("Unable to write ") + wavName);
+    }
+    AudioOutput* output = 0;
+    if (headless) {
+        output = &headlessOutput;
+    } else if (useMixer) {
+        output = &deviceOutput;
+    }
+    if (output) {
+        kit.useMixer(&mixer);
+        if (!output->start()) {
+            throw std::runtime_error("Unable to start the mixer output");
+        }
+    }
+
+    // --replay plays the log through the collector at the speed it was recorded, with no Myo at all.
+    if (replayName) {
+        EventReplay replay;
+        if (!replay.open(replayName)) {
+            throw std::runtime_error(std::string("Unable to open event log ") + replayName);
+        }
+        std::cout << "Replaying " << replay.count() << " events from " << replayName << "." << std::endl;
+        replay.run(collector);
+        log.flush();
+        std::cout << "Replayed " << collector.strikes << " strikes." << std::endl;
+        if (output) {
+            // Let the last strikes ring out, so neither they nor a --wav file are cut off mid-sample.
+            for (int waited = 0; waited < 10000 && !mixer.idle(); waited += 10) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            output->stop();
+        }
+        return 0;
+    }
 
     // First, we create a Hub with our application identifier. Be sure not to use the com.example namespace when
     // publishing your application. The Hub provides access to one or more Myos.
@@ -292,139 +237,67 @@ int main(int argc, char** argv)
     // We've found a Myo.
     std::cout << "Connected to a Myo armband!" << std::endl << std::endl;
 
-    // Next we construct an instance of our DeviceListener, so that we can register it with the Hub.
-    DataCollector collector;
+    // The recorder listens to the Hub directly, on whichever thread runs it.
+    EventRecorder recorder;
+    if (recordName) {
+        if (!recorder.open(recordName)) {
+            throw std::runtime_error(std::string("Unable to write event log ") + recordName);
+        }
+        hub.addListener(&recorder);
+    }
 
     // Hub::addListener() takes the address of any object whose class inherits from DeviceListener, and will cause
-    // Hub::run() to send events to all registered device listeners.
-    hub.addListener(&collector);
+    // Hub::run() to send events to all registered device listeners, in the order they were added. In sensor thread
+    // mode the collector is not one of them: the SensorThread is, after the recorder if there is one, and it forwards
+    // the events to the collector on this thread.
+    SensorThread sensors(hub);
+    if (useSensorThread) {
+        sensors.start();
+    } else {
+        hub.addListener(&collector);
+    }
 	bool boolean = true;
-	int step = 75;
+	uint64_t reportedDrops = 0;
 	
 	//engine->stopAllSounds();
 	//engine->drop(); // delete engine
 
 	
 	//collector.currentPose();
-	bool allowedSound[2] = { false, false };
     // Finally we enter our main loop.
     while (1) {
-        // In each iteration of our main loop, we run the Myo event loop for a set number of milliseconds.
-        // In this case, we wish to update our display 20 times a second, so we run for 1000/20 milliseconds.
-        hub.run(1000/100);
+        if (useSensorThread) {
+            // Hand every sample queued by the sensor thread to the collector. If nothing new has arrived there is
+            // nothing to do, so sleep until the sensor thread queues something, looking again at least every 10 ms.
+            if (sensors.dispatch(collector) == 0) {
+                sensors.waitForEvents(10);
+                continue;
+            }
+            // Say so whenever the collector fell far enough behind for the sensor thread to drop samples.
+            uint64_t dropped = sensors.dropped();
+            if (dropped != reportedDrops) {
+                LogLine line;
+                line << static_cast<long long>(dropped - reportedDrops) << " sensor events dropped; "
+                     << static_cast<long long>(dropped) << " in all.\n";
+                log.write(line);
+                reportedDrops = dropped;
+            }
+        } else {
+            // In each iteration of our main loop, we run the Myo event loop for a set number of milliseconds.
+            // In this case, we wish to update our display 20 times a second, so we run for 1000/20 milliseconds.
+            hub.run(1000/100);
+        }
         // After processing events, we call the print() member function we defined above to print out the values we've
         // obtained from any events that have occurred.
 		if (boolean) {
 			collector.print();
 			boolean = false;
 		}
-		int c_yaw[2];
-		//if (collector.roll_w[0])
-		for (int i = 0; i < collector.knownMyos.size(); i++)
-		{
-			
-			if (collector.pitch_w[i] - collector.origin_pitch[i] > 45) {
-				allowedSound[i] = true;
-			}
-			if (collector.pitch_w[i] - collector.origin_pitch[i] < 40 && allowedSound[i]) {
-
-				c_yaw[i] = correction(collector.yaw_w[i], collector.origin_yaw[i]);
-				//Right Arm
-				if (i == 0) {
-					collector.printRight();
-					std::cout << " --------- Right c_yaw: " << c_yaw[i] << "\n";
-					if (c_yaw[i] >= 35 && c_yaw[i] < 150) {
-						std::cout << " ZONE 1: Cymbals" << "\n";
-						irrklang::ISound *sound = engine->play2D("Sounds/crash_cymbals.wav", false, false);
-						if (sound)
-							sound->drop();
-					}
-					else if ((c_yaw[i] < 35 && c_yaw >= 0) || (c_yaw[i] > 320 && c_yaw[i] <= 359)) {
-						std::cout << " ZONE 2: Snare" << "\n";
-						irrklang::ISound *sound = engine->play2D("Sounds/909_snr2.wav", false, false);
-						if (sound)
-						sound->drop();	
-					}
-					else if (c_yaw[i] < 320 && c_yaw[i] >= 260) {
-						std::cout << " ZONE 3: Tom 2" << "\n";
-						irrklang::ISound *sound = engine->play2D("Sounds/tom2.wav", false, false);
-						if (sound)
-						sound->drop();
-					}
-					else if (c_yaw[i]  < 260 && c_yaw[i] >= 150) {
-						std::cout << " ZONE 4: Floor Tom" << "\n";
-
-						irrklang::ISound *sound = engine->play2D("Sounds/tomfloor.wav", false, false);
-						if (sound)
-						sound->drop();
-					}
-				}
-				//Left arm
-				else {
-					collector.printLeft();
-					std::cout << " --------- Left c_yaw: " << c_yaw[i] << "\n";
-					if (c_yaw[i] >= 90 && c_yaw[i] < 260) {
-						std::cout << " ZONE 4: High Hat" << "\n";
-						irrklang::ISound *sound = engine->play2D("Sounds/hh4.wav", false, false);
-						if (sound)
-							sound->drop();
-					}
-					else if (c_yaw[i] >= 40 && c_yaw[i] < 90) {
-						std::cout << " ZONE 3: Snare" << "\n";
-						irrklang::ISound *sound = engine->play2D("Sounds/909_snr2.wav", false, false);
-						if (sound)
-							sound->drop();
-					}
-					else if (c_yaw[i] < 40 || c_yaw[i] >= 320) {
-						std::cout << " ZONE 2: Tom 1" << "\n";
-						irrklang::ISound *sound = engine->play2D("Sounds/tom1.wav", false, false);
-						if (sound)
-							sound->drop();
-					}
-					else if (c_yaw[i]  >= 260 && c_yaw[i] < 320) {
-						std::cout << " ZONE 1: Bass" << "\n";
-
-						irrklang::ISound *sound = engine->play2D("Sounds/bassdr04.wav", false, false);
-						if (sound)
-							sound->drop();
-					}
-				}
-				allowedSound[i] = false;
-				// play some sound stream, not looped
-
-				
-				/*if (c_yaw[i] < step) {
-					irrklang::ISound *sound = engine->play2D(sounds[i][0], false, false);
-					if (sound)
-						sound->drop();
-				}
-				else if (delta_yaw >= step) {
-					irrklang::ISound *sound = engine->play2D(sounds[i][1], false, false);
-					if (sound)
-						sound->drop();
-				}
-				else if (delta_yaw < 0 && delta_yaw >= -step) {
-					irrklang::ISound *sound = engine->play2D(sounds[i][2], false, false);
-					if (sound)
-						sound->drop();
-				}
-				else if (delta_yaw  < -step) {
-					irrklang::ISound *sound = engine->play2D(sounds[i][3], false, false);
-					if (sound)
-						sound->drop();
-				}*/
-
-			
-				
-			}
-			/*
-					if (collector.pitch_w > 180 && collector.pitch_w < 220) {
-						std::cout << "Wassup bitches!!\n";
-					}*/
-		}
     }
 
-	engine->drop();
+	if (engine) {
+		engine->drop();
+	}
 
     // If a standard exception occurred, we print out its message and exit.
     } catch (const std::exception& e) {
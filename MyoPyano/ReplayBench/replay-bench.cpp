@@ -0,0 +1,81 @@
+// Throughput benchmark of the strike and zone logic: replays an event log made with MyoPyano --record through
+// DataCollector as fast as possible and prints the events and strikes handled per second. The kit plays the samples
+// in Sounds, if there are any, into a mixer that only ever mixes between rounds, outside the timing, to empty its
+// queue of triggers; the figures leave out audio entirely. Triggers the queue had no room for are reported.
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "../MyoPyano/src/DataCollector.hpp"
+#include "../MyoPyano/src/EventReplay.hpp"
+#include "../MyoPyano/src/Mixer.hpp"
+#include "../MyoPyano/src/SampleBank.hpp"
+
+// Usage: replay-bench <log> [rounds] [--direction-zones] [--fusion]
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "Usage: replay-bench <log> [rounds] [--direction-zones] [--fusion]" << std::endl;
+        return 1;
+    }
+    int rounds = argc > 2 && argv[2][0] != '-' ? atoi(argv[2]) : 10;
+    bool directionZones = false;
+    bool fusion = false;
+    for (int i = 2; i < argc; i++) {
+        directionZones = directionZones || strcmp(argv[i], "--direction-zones") == 0;
+        fusion = fusion || strcmp(argv[i], "--fusion") == 0;
+    }
+
+    EventReplay replay;
+    if (!replay.open(argv[1]) || replay.count() == 0 || rounds <= 0) {
+        std::cerr << "Unable to replay " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // No sound engine at all: the kit only plays into the mixer. The kit is made, and its samples added to the
+    // mixer, once, before anything is timed.
+    {
+        SampleBank bank(0);
+        bank.loadDirectory("Sounds");
+        Mixer mixer;
+        DrumKit kit(0, bank);
+        kit.useMixer(&mixer);
+        std::vector<float> block(mixer.maxBlockFrames() * 2);
+
+        double best = 1e300;
+        uint64_t strikes = 0;
+        // Every strike prints a line; keep that out of the figures too.
+        std::cout.setstate(std::ios::failbit);
+        // Best of several rounds, each from a fresh collector, to keep other processes out of the figure.
+        for (int round = 0; round < rounds; round++) {
+            DataCollector<PolynomialTrig> collector(kit, true, directionZones);
+            if (fusion) {
+                collector.enableFusion(0.010f);
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            replay.run(collector, 0);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+            strikes = collector.strikes;
+            // Take the round's triggers off the queue so the next round has room for its own.
+            mixer.mix(&block[0], mixer.maxBlockFrames());
+        }
+        std::cout.clear();
+
+        std::cout << replay.count() << " events, " << strikes << " strikes, best of " << rounds << " rounds"
+                  << std::endl;
+        std::cout << std::fixed << std::setprecision(0)
+                  << std::setw(12) << replay.count() / best << " events/s" << std::endl
+                  << std::setw(12) << strikes / best << " strikes/s" << std::endl
+                  << std::setprecision(1)
+                  << std::setw(12) << best * 1e9 / replay.count() << " ns/event" << std::endl;
+        if (mixer.triggersDropped() > 0) {
+            std::cout << mixer.triggersDropped() << " triggers dropped; the mixer's queue was full" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Microbenchmark of the orientation math: libm against the FastTrig.hpp polynomials, one quaternion at a time as
+// DataCollector does it, and the batched SIMD kernel. Prints the time per quaternion and the largest difference
+// from libm, in degrees.
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdlib.h>
+#include <vector>
+
+#include "../MyoPyano/src/EulerBatch.hpp"
+#include "../MyoPyano/src/FastTrig.hpp"
+
+// A block of random unit quaternions, stored both ways the converters want them.
+struct Quaternions {
+    std::vector<float> x, y, z, w;
+};
+
+Quaternions randomQuaternions(size_t count)
+{
+    std::mt19937 random(1);
+    std::normal_distribution<float> normal;
+    Quaternions q;
+    q.x.resize(count);
+    q.y.resize(count);
+    q.z.resize(count);
+    q.w.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        float x = normal(random), y = normal(random), z = normal(random), w = normal(random);
+        float length = std::sqrt(x * x + y * y + z * z + w * w);
+        q.x[i] = x / length;
+        q.y[i] = y / length;
+        q.z[i] = z / length;
+        q.w[i] = w / length;
+    }
+    return q;
+}
+
+// Convert one quaternion at a time, with the same formulas as DataCollector::updateEulerAngles().
+template <typename Trig>
+void convert(const Quaternions& q, float* roll, float* pitch, float* yaw)
+{
+    for (size_t i = 0; i < q.x.size(); i++) {
+        float x = q.x[i], y = q.y[i], z = q.z[i], w = q.w[i];
+        roll[i] = Trig::atan2(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y));
+        pitch[i] = Trig::asin(std::max(-1.0f, std::min(1.0f, 2.0f * (w * y - z * x))));
+        yaw[i] = Trig::atan2(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z));
+    }
+}
+
+// Largest difference between two arrays of angles, in degrees, allowing for the wrap at +-pi.
+double maxError(const std::vector<float>& a, const std::vector<float>& b)
+{
+    double worst = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        double error = std::fabs(static_cast<double>(a[i]) - b[i]);
+        worst = std::max(worst, std::min(error, 2 * M_PI - error));
+    }
+    return worst * 180 / M_PI;
+}
+
+struct Result {
+    std::vector<float> roll, pitch, yaw;
+    double nanoseconds;
+};
+
+template <typename Convert>
+Result run(const Quaternions& q, int rounds, Convert convert)
+{
+    Result result;
+    result.roll.resize(q.x.size());
+    result.pitch.resize(q.x.size());
+    result.yaw.resize(q.x.size());
+    result.nanoseconds = 1e300;
+    // Best of several rounds, to keep other processes out of the figure.
+    for (int round = 0; round < rounds; round++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        convert(q, &result.roll[0], &result.pitch[0], &result.yaw[0]);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        result.nanoseconds = std::min(result.nanoseconds, elapsed.count() / q.x.size());
+    }
+    return result;
+}
+
+void batch(const Quaternions& q, float* roll, float* pitch, float* yaw)
+{
+    quaternionsToEuler(&q.x[0], &q.y[0], &q.z[0], &q.w[0], roll, pitch, yaw, q.x.size());
+}
+
+void report(const char* name, const Result& result, const Result& reference)
+{
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(8) << result.nanoseconds << " ns" << std::setprecision(5)
+              << std::setw(12) << maxError(result.roll, reference.roll)
+              << std::setw(12) << maxError(result.pitch, reference.pitch)
+              << std::setw(12) << maxError(result.yaw, reference.yaw) << std::endl;
+}
+
+// Usage: trig-bench [quaternions] [rounds]
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 1000000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 10;
+    if (count == 0 || rounds <= 0) {
+        std::cerr << "Usage: trig-bench [quaternions] [rounds]" << std::endl;
+        return 1;
+    }
+    Quaternions q = randomQuaternions(count);
+
+    Result libm = run(q, rounds, convert<LibmTrig>);
+    Result polynomial = run(q, rounds, convert<PolynomialTrig>);
+    Result simd = run(q, rounds, batch);
+
+    std::cout << count << " quaternions, best of " << rounds << " rounds; max error against libm in degrees"
+              << std::endl;
+    std::cout << std::left << std::setw(12) << "" << std::right << std::setw(11) << "per quat"
+              << std::setw(12) << "roll" << std::setw(12) << "pitch" << std::setw(12) << "yaw" << std::endl;
+    report("libm", libm, libm);
+    report("polynomial", polynomial, libm);
+    report("batch SIMD", simd, libm);
+    return 0;
+}